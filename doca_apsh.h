@@ -97,6 +97,39 @@ enum doca_apsh_system_os {
 	DOCA_APSH_SYSTEM_WINDOWS, /**< windows */
 };
 
+/**
+ * @brief process object kinds, for doca_apsh_processes_objects_get
+ */
+enum doca_apsh_object_kind {
+	DOCA_APSH_OBJECT_LIBS = (1 << 0),    /**< process loadable libraries */
+	DOCA_APSH_OBJECT_THREADS = (1 << 1), /**< process threads */
+	DOCA_APSH_OBJECT_VADS = (1 << 2),    /**< process virtual address descriptors */
+};
+
+/**
+ * @brief objects of one process, filled by doca_apsh_processes_objects_get
+ *
+ * Each array is snapshot, need to free it with the free function of its kind.
+ * The size of an array is an error code on negative value.
+ */
+struct doca_apsh_process_objects {
+	struct doca_apsh_lib **libs;	   /**< Array of libs opaque pointers of the process */
+	int nb_libs;			   /**< Size of the libs array */
+	struct doca_apsh_thread **threads; /**< Array of threads opaque pointers of the process */
+	int nb_threads;			   /**< Size of the threads array */
+	struct doca_apsh_vad **vads;	   /**< Array of vads opaque pointers of the process */
+	int nb_vads;			   /**< Size of the vads array */
+};
+
+/**
+ * @brief process change types, returned by doca_apsh_processes_delta_get
+ */
+enum doca_apsh_process_change {
+	DOCA_APSH_PROCESS_CREATED, /**< process was created since the previous generation */
+	DOCA_APSH_PROCESS_EXITED,  /**< process exited since the previous generation */
+	DOCA_APSH_PROCESS_CHANGED, /**< process attributes changed since the previous generation */
+};
+
 /**
  * @brief Create a new apsh handler
  *
@@ -164,6 +197,22 @@ int doca_apsh_dma_dev_set(struct doca_apsh_ctx *ctx, const char *dma_dev_name);
 __DOCA_EXPERIMENTAL
 int doca_apsh_regex_dev_set(struct doca_apsh_ctx *ctx, const char *regex_dev_name);
 
+/**
+ * @brief Set apsh hash device
+ *
+ * This is a optional setter
+ * When set, the attestation hashes are computed by the device instead of the cpu.
+ *
+ * @param ctx
+ *   apsh handler
+ * @param sha_dev_name
+ *   device name with the capabilities of sha
+ * @return
+ *   0 on success, error code otherwise.
+ */
+__DOCA_EXPERIMENTAL
+int doca_apsh_sha_dev_set(struct doca_apsh_ctx *ctx, const char *sha_dev_name);
+
 /**
  * @brief Create a new system handler
  *
@@ -290,6 +339,60 @@ int doca_apsh_sys_system_layer_set(struct doca_apsh_system *system,
 __DOCA_EXPERIMENTAL
 int doca_apsh_sys_os_type_set(struct doca_apsh_system *system, enum doca_apsh_system_layer os_type);
 
+/**
+ * @brief Set system attestation full hash period
+ *
+ * This is a optional setter
+ * Every period refreshes of an attestation handler, doca_apsh_attst_refresh reads
+ * and hashes again all the pages instead of only the remapped and dirty ones, so
+ * in place writes hidden from the guest page table dirty bits are detected
+ * within period refreshes. The default is 16.
+ *
+ * @param system
+ *   system handler
+ * @param period
+ *   number of refreshes between full hashes, 1 to hash all the pages on every refresh
+ * @return
+ *   0 on success, error code otherwise.
+ */
+__DOCA_EXPERIMENTAL
+int doca_apsh_sys_attst_full_hash_period_set(struct doca_apsh_system *system, uint32_t period);
+
+/**
+ * @brief Set system exec hash map
+ *
+ * This is a optional setter
+ * The hash map is loaded once into an indexed structure shared by all the
+ * attestations of the system, see doca_apsh_attestation_get.
+ * Can be called again to load an updated map.
+ *
+ * @param system
+ *   system handler
+ * @param exec_hash_map_path
+ *   path to file containing the hash calculations of the executables and dlls/libs
+ *   The file can be created by running the doca_exec_hash_build_map tool on the system.
+ * @return
+ *   0 on success, error code otherwise.
+ */
+__DOCA_EXPERIMENTAL
+int doca_apsh_sys_exec_hash_map_set(struct doca_apsh_system *system,
+				    const char *exec_hash_map_path);
+
+/**
+ * @brief Set system number of query workers
+ *
+ * This is a optional setter
+ *
+ * @param system
+ *   system handler
+ * @param nb_workers
+ *   number of internal workers used by doca_apsh_processes_objects_get, default is 1
+ * @return
+ *   0 on success, error code otherwise.
+ */
+__DOCA_EXPERIMENTAL
+int doca_apsh_sys_workers_set(struct doca_apsh_system *system, int nb_workers);
+
 /**
  * @brief Get array of current modules installed on the system
  *
@@ -375,6 +478,44 @@ int doca_apsh_processes_get(struct doca_apsh_system *system, struct doca_apsh_pr
 __DOCA_EXPERIMENTAL
 void doca_apsh_processes_free(struct doca_apsh_process **processes);
 
+/**
+ * @brief Get array of processes changed on the system since the previous generation
+ *
+ * The system context keeps the kernel structures read by the previous call as a
+ * generation. The task list links are still walked on each call, but the full task
+ * structs are read only for the processes that changed since then. The first call
+ * returns all processes as created.
+ * Exited processes hold their last snapshot.
+ *
+ * This function is multithreaded compatible with diffrent system context,
+ * meaning do not call this function simultaneously with the same system context.
+ * The return array is snapshot, this is not dynamic array, need to free it with
+ * doca_apsh_processes_free, the changes array need to be freed with
+ * doca_apsh_process_changes_free.
+ *
+ * @param system
+ *   System handler
+ * @param processes
+ *   Array of process opaque pointers of the changed processes
+ * @param changes
+ *   Array of the change type of each process in the processes array
+ * @return
+ *   Size of the arrays, error code on negative value.
+ */
+__DOCA_EXPERIMENTAL
+int doca_apsh_processes_delta_get(struct doca_apsh_system *system,
+				  struct doca_apsh_process ***processes,
+				  enum doca_apsh_process_change **changes);
+
+/**
+ * @brief Destroys the changes array returned by doca_apsh_processes_delta_get
+ *
+ * @param changes
+ * 	 Array of the change types to destroy
+ */
+__DOCA_EXPERIMENTAL
+void doca_apsh_process_changes_free(enum doca_apsh_process_change *changes);
+
 /**
  * @brief Shadow function - get attribute value for a process
  *
@@ -596,6 +737,36 @@ const void *__doca_apsh_vad_info_get(struct doca_apsh_vad *vad, enum doca_apsh_l
  */
 #define doca_apsh_vad_info_get(vad, attr) ((attr##_TYPE)__doca_apsh_vad_info_get(vad, attr))
 
+/**
+ * @brief Get the libs, threads and/or vads of many processes
+ *
+ * Batched variant of doca_apsh_libs_get, doca_apsh_threads_get and
+ * doca_apsh_vads_get. The memory reads of all the processes are issued as scatter
+ * gather DMA reads with many requests in flight, and are spread on the internal
+ * workers of the system, see doca_apsh_sys_workers_set.
+ *
+ * This function is multithreaded compatible with diffrent system context,
+ * meaning do not call this function simultaneously with the same system context.
+ * All the processes must belong to the same system.
+ *
+ * @param system
+ *   System handler
+ * @param processes
+ *   Array of process handlers
+ * @param nb_processes
+ *   Size of the processes array
+ * @param kinds
+ *   doca_apsh_object_kind flags of the objects to get
+ * @param objects
+ *   Array of nb_processes objects, objects[i] is filled with the objects of processes[i]
+ * @return
+ *   0 on success, error code otherwise.
+ */
+__DOCA_EXPERIMENTAL
+int doca_apsh_processes_objects_get(struct doca_apsh_system *system,
+				    struct doca_apsh_process **processes, int nb_processes,
+				    uint32_t kinds, struct doca_apsh_process_objects *objects);
+
 /**
  * @brief Get current process attestation
  *
@@ -609,6 +780,8 @@ const void *__doca_apsh_vad_info_get(struct doca_apsh_vad *vad, enum doca_apsh_l
  *   path to file containing the hash calculations of the executable and dlls/libs of the process
  *   note that changing the process code or any libs can effect this.
  *   The file can be created by running the doca_exec_hash_build_map tool on the system.
+ *   NULL to use the map loaded by doca_apsh_sys_exec_hash_map_set, which avoids parsing
+ *   the file on every call.
  * @param attestation
  *   Attestation opaque pointers of the process
  * @return
@@ -666,6 +839,12 @@ const void *__doca_apsh_attst_info_get(struct doca_apsh_attestation *attestation
  * This function is multithreaded compatible with diffrent system context,
  * Refresh the snapshot of the handler.
  * Recommended to query all wanted information before refreshing.
+ * The hash of each page is cached with the physical page it was read from. A
+ * page is read and hashed again when it was remapped to another physical page,
+ * or when its guest page table dirty bit shows it was written in place since the
+ * previous snapshot. The guest can clear the dirty bits, so they are not trusted
+ * alone: every full hash period refreshes, all the pages are read and hashed
+ * again, see doca_apsh_sys_attst_full_hash_period_set.
  *
  * @param attestation
  *   single attestation handler to refresh
@@ -51,6 +51,18 @@ enum doca_dpi_enqueue_status_t {
 	/**< load_signatures failed, or was never called */
 	DOCA_DPI_ENQ_INTERNAL_ERR,
 	/* Other system errors possible */
+	DOCA_DPI_ENQ_INSPECTION_DONE,
+	/**< Flow reached its inspection limit, packet was not queued */
+};
+
+/**
+ * @brief Flags of payload enqueue operation
+ */
+enum doca_dpi_enqueue_flags_t {
+	DOCA_DPI_ENQ_FLAG_NONE = 0,
+	/**< Packet is owned by the DPI until it is dequeued */
+	DOCA_DPI_ENQ_FLAG_RELEASE_PKT = 1 << 0,
+	/**< Packet is owned by the user once enqueue returns */
 };
 
 /**
@@ -73,6 +85,10 @@ enum doca_dpi_flow_status_t {
 	/**< Indicates flow was destroyed while being processed */
 	DOCA_DPI_STATUS_NEW_MATCH = 1 << 3,
 	/**< Indicates flow was matched on current dequeue */
+	DOCA_DPI_STATUS_OFFLOADED = 1 << 4,
+	/**< Indicates flow verdict was offloaded on current dequeue */
+	DOCA_DPI_STATUS_INSPECTION_DONE = 1 << 5,
+	/**< Indicates flow reached its inspection limit on current dequeue */
 };
 
 /**
@@ -97,6 +113,36 @@ enum doca_dpi_sig_action_t {
 	/**< Send RST/ICMP error packets to both sides of the conversation */
 };
 
+/**
+ * @brief Status of asynchronous signatures load
+ */
+enum doca_dpi_load_status_t {
+	DOCA_DPI_LOAD_IDLE,
+	/**< No asynchronous load was started */
+	DOCA_DPI_LOAD_IN_PROGRESS,
+	/**< New database is being compiled and programmed */
+	DOCA_DPI_LOAD_SWITCHING,
+	/**< New database is ready, jobs on the previous one are not all dequeued */
+	DOCA_DPI_LOAD_DONE,
+	/**< All queues use the new database, the previous one is released */
+	DOCA_DPI_LOAD_FAILED,
+	/**< Load failed, the previous database is still in use */
+};
+
+/**
+ * @brief Flow inspection policy
+ *
+ * Once a flow reaches one of the limits, its next packets are not inspected.
+ */
+struct doca_dpi_inspect_policy {
+	uint64_t max_bytes;
+	/**< Max payload bytes inspected per flow, 0 for no limit */
+	uint32_t max_packets;
+	/**< Max packets inspected per flow, 0 for no limit */
+	bool stop_on_match;
+	/**< Stop inspecting a flow on its first match of a signature with an action */
+};
+
 /**
  * @brief DPI init configuration
  */
@@ -107,6 +153,12 @@ struct doca_dpi_config_t {
 	/**< Number of packets concurrently processed by the DPI engine. */
 	uint32_t max_sig_match_len;
 	/**< The minimum required overlap between two packets for regex match */
+	uint32_t max_flows_per_queue;
+	/**< Size of the flow contexts pool and flow table of each queue, 0 to disable */
+	uint32_t flow_idle_timeout;
+	/**< Idle timeout in seconds of flows in the flow table, 0 for no timeout */
+	struct doca_dpi_inspect_policy inspect_policy;
+	/**< Default inspection policy of new flows, all zero for no limit */
 };
 
 /**
@@ -171,6 +223,8 @@ struct doca_dpi_result {
 	/**< Signature information */
 	int status_flags;
 	/**< doca_dpi_flow_status flags */
+	uint32_t db_generation;
+	/**< Generation of the signatures database that produced the result */
 };
 
 /**
@@ -195,6 +249,75 @@ struct doca_dpi_stat_info {
 	/**< Total number of other l7 signature matches */
 };
 
+/**
+ * @brief doca flow pipeline struct, see doca_flow.h
+ */
+struct doca_flow_pipe;
+
+/**
+ * @brief Bit set in the aging user data of the doca flow entries added by the
+ * DPI offload. Aged entries of the application on the same doca flow queues
+ * must keep this bit clear in their user data.
+ */
+#define DOCA_DPI_OFFLOAD_USER_DATA_FLAG (1ULL << 63)
+
+/**
+ * @brief DPI verdict offload configuration
+ *
+ * The pipes must match on the outer 5-tuple (source and destination ip,
+ * layer 4 protocol, source and destination port), and their fwd defines what
+ * is done with the offloaded flows, for example drop, forward to a port or
+ * hairpin.
+ */
+struct doca_dpi_offload_cfg {
+	struct doca_flow_pipe *drop_pipe;
+	/**< Pipe for flows with DOCA_DPI_SIG_ACTION_DROP verdict, NULL to not offload */
+	struct doca_flow_pipe *pass_pipe;
+	/**< Pipe for flows with DOCA_DPI_SIG_ACTION_PASS verdict, NULL to not offload */
+	uint32_t aging;
+	/**< Aging time in seconds of the offloaded entries, 0 for no aging */
+};
+
+/**
+ * @brief Number of buckets of the DPI queue latency histogram
+ */
+#define DOCA_DPI_LATENCY_HIST_BUCKETS 16
+
+/**
+ * @brief Number of buckets of the DPI queue occupancy histogram
+ */
+#define DOCA_DPI_OCCUPANCY_HIST_BUCKETS 8
+
+/**
+ * @brief DPI queue statistics
+ *
+ * All counters are monotonic since init and never cleared.
+ */
+struct doca_dpi_queue_stat_info {
+	uint64_t nb_enqueued;
+	/**< Total number of packets enqueued for processing */
+	uint64_t nb_dequeued;
+	/**< Total number of packets dequeued */
+	uint64_t nb_enq_busy;
+	/**< Total number of enqueues rejected with DOCA_DPI_ENQ_BUSY */
+	uint64_t nb_enq_empty;
+	/**< Total number of enqueues rejected with DOCA_DPI_ENQ_PACKET_EMPTY */
+	uint64_t nb_matches;
+	/**< Total number of signature matches */
+	uint32_t in_flight;
+	/**< Number of packets currently processed, up to max_packets_per_queue */
+	uint32_t max_in_flight;
+	/**< Highest number of packets processed at the same time */
+	uint64_t latency_hist[DOCA_DPI_LATENCY_HIST_BUCKETS];
+	/**< Enqueue to dequeue latency, bucket i counts packets with latency of
+	 *   [2^i, 2^(i+1)) micro seconds, first and last buckets are open ended.
+	 */
+	uint64_t occupancy_hist[DOCA_DPI_OCCUPANCY_HIST_BUCKETS];
+	/**< Queue occupancy on enqueue, bucket i counts enqueues done when
+	 *   in_flight was in [i, i+1) eighths of max_packets_per_queue.
+	 */
+};
+
 /**
  * @brief Opaque flow context
  */
@@ -241,6 +364,9 @@ void doca_dpi_destroy(struct doca_dpi_ctx *ctx);
  * function again.
  * The newly loaded CDO must contain the signatures of the previously loaded CDO
  * or result will be undefined.
+ * This call blocks until the database is programmed, and no packets may be
+ * enqueued meanwhile. To update the database while processing packets, use
+ * doca_dpi_load_signatures_async.
  * @param ctx
  *   The DPI context.
  * @param cdo_file
@@ -251,6 +377,83 @@ void doca_dpi_destroy(struct doca_dpi_ctx *ctx);
 __DOCA_EXPERIMENTAL
 int doca_dpi_load_signatures(struct doca_dpi_ctx *ctx, const char *cdo_file);
 
+/**
+ * @brief Loads a new cdo file without stopping packet processing.
+ *
+ * The new database is compiled and programmed to the regex device in the
+ * background, while the current database keeps serving all queues. Once it
+ * is ready, all the following enqueues, on any queue, use it, and jobs that
+ * were already enqueued finish against the previous database. A queue holds
+ * the previous database only through its jobs in flight, so a queue that has
+ * none, or never enqueues again, does not delay the release. The previous
+ * database is released, and the status becomes DOCA_DPI_LOAD_DONE, when all
+ * the jobs enqueued on it were dequeued, by the next doca_dpi_dequeue or
+ * doca_dpi_dequeue_burst calls of their queues.
+ *
+ * Each database gets a generation number, incremented by every successful
+ * load, which is returned in doca_dpi_result.db_generation.
+ *
+ * The new CDO does not have to contain the signatures of the previous CDO.
+ * A signature match that spans packets enqueued before and after the switch
+ * of a queue may be missed.
+ *
+ * Only one asynchronous load can be in progress on a context.
+ * @param ctx
+ *   The DPI context.
+ * @param cdo_file
+ *   CDO file created by the DPI compiler.
+ * @return
+ *   0 if the load was started, error code otherwise.
+ */
+__DOCA_EXPERIMENTAL
+int doca_dpi_load_signatures_async(struct doca_dpi_ctx *ctx, const char *cdo_file);
+
+/**
+ * @brief Returns the status of the asynchronous signatures load.
+ *
+ * @param ctx
+ *   The DPI context.
+ * @param db_generation
+ *   Output, if not NULL, generation of the newest database ready for use.
+ * @return
+ *   doca_dpi_load_status_t on success, error code otherwise.
+ */
+__DOCA_EXPERIMENTAL
+int doca_dpi_load_signatures_status(const struct doca_dpi_ctx *ctx, uint32_t *db_generation);
+
+/**
+ * @brief Sets the DPI verdict offload to doca flow.
+ *
+ * When set, once a flow is matched on a signature with DROP or PASS action,
+ * the DPI adds one doca flow entry for each direction of the flow to the pipe
+ * of the verdict, and the result is dequeued with DOCA_DPI_STATUS_OFFLOADED.
+ * The following packets of the flow are handled by HW and do not reach the
+ * application.
+ *
+ * The entries are added on the doca flow queue with the same number as the
+ * DPI queue of the flow, so doca flow must be initialized with at least
+ * nb_queues queues. The entries are removed by doca_dpi_flow_destroy.
+ *
+ * When aging is set, both entries are added with it and each one ages on the
+ * traffic of its own direction. Their user data is a DPI handle of the flow
+ * with DOCA_DPI_OFFLOAD_USER_DATA_FLAG set, not the flow context pointer. The
+ * application should pass the user data returned by doca_flow_handle_aging on
+ * a queue to doca_dpi_flow_aged with the DPI queue of the same number, which
+ * returns the flow context only once both entries of the flow aged, and then
+ * call doca_dpi_flow_destroy on it. This way a flow is reported once, and a
+ * flow with traffic in one direction only is not destroyed while it is active.
+ * Offloaded flows are not destroyed by doca_dpi_flow_table_expire.
+ *
+ * @param ctx
+ *   The DPI context.
+ * @param cfg
+ *   Offload configuration, NULL to disable the offload of new verdicts.
+ * @return
+ *   0 on success, error code otherwise.
+ */
+__DOCA_EXPERIMENTAL
+int doca_dpi_offload_set(struct doca_dpi_ctx *ctx, const struct doca_dpi_offload_cfg *cfg);
+
 /**
  * @brief Enqueue a new DPI job for processing.
  *
@@ -265,6 +468,7 @@ int doca_dpi_load_signatures(struct doca_dpi_ctx *ctx, const char *cdo_file);
  * The injected packet has to be stripped of FCS.
  * A packet will not be enqueued if:
  * - Payload length = 0
+ * - The flow reached its inspection limit, see doca_dpi_inspect_policy
  *
  * @param flow_ctx
  * The flow context handler.
@@ -304,6 +508,107 @@ int doca_dpi_enqueue(struct doca_dpi_flow_ctx *flow_ctx, struct rte_mbuf *pkt,
 __DOCA_EXPERIMENTAL
 int doca_dpi_dequeue(struct doca_dpi_ctx *ctx, uint16_t dpi_q, struct doca_dpi_result *result);
 
+/**
+ * @brief Enqueue a payload slice of a packet for processing.
+ *
+ * Same as doca_dpi_enqueue, with an explicit payload length and support of
+ * chained mbufs. The segments of a chained mbuf are scanned in place, there is
+ * no need to linearize the packet. payload_offset and payload_len are relative
+ * to the start of the whole packet, the slice may span several segments.
+ *
+ * With DOCA_DPI_ENQ_FLAG_RELEASE_PKT, only the payload slice is copied to the
+ * job buffer of the device, and the mbuf is owned again by the user when this
+ * function returns, it can be forwarded or freed right away. The pkt field of
+ * the dequeued result is NULL in this case.
+ *
+ * @param flow_ctx
+ * The flow context handler.
+ * @param pkt
+ * The mbuf to be processed, may be chained.
+ * @param initiator
+ * Indicates to which direction the packet belongs, see doca_dpi_enqueue.
+ * @param payload_offset
+ * Indicates where the packet's payload begins.
+ * @param payload_len
+ * Length of the payload to scan, 0 for up to the end of the packet.
+ * @param flags
+ * doca_dpi_enqueue_flags_t flags.
+ * @param user_data
+ * Private user data to b returned when the DPI job is dequeued.
+ * @return
+ * doca_dpi_enqueue_status_t or other error code.
+ */
+__DOCA_EXPERIMENTAL
+int doca_dpi_enqueue_payload(struct doca_dpi_flow_ctx *flow_ctx, struct rte_mbuf *pkt,
+			     bool initiator, uint32_t payload_offset, uint32_t payload_len,
+			     uint32_t flags, void *user_data);
+
+/**
+ * @brief Enqueue a burst of new DPI jobs for processing.
+ *
+ * Burst variant of doca_dpi_enqueue, the packets are submitted to the regex
+ * device in one batch. All the flows must be created on the same DPI queue,
+ * and the same threading and packet ownership rules as doca_dpi_enqueue apply.
+ *
+ * Packets are handled in array order. Packets without payload are not
+ * enqueued and their status is set to DOCA_DPI_ENQ_PACKET_EMPTY, packets of
+ * flows that reached their inspection limit are not enqueued and their status
+ * is set to DOCA_DPI_ENQ_INSPECTION_DONE, in both cases the burst continues
+ * with the next packet. Enqueue stops on the first packet that cannot be
+ * enqueued because the queue is full, this packet and the following ones are
+ * not handled.
+ *
+ * A packet that fails with DOCA_DPI_ENQ_INVALID_DB or DOCA_DPI_ENQ_INTERNAL_ERR
+ * also stops the burst: its status is set, it is not counted in the returned
+ * number and the following packets are not handled. If it is the first packet,
+ * the error code is returned.
+ *
+ * @param flow_ctxs
+ * Array of flow context handlers.
+ * @param pkts
+ * Array of mbufs to be processed.
+ * @param initiators
+ * Array of packet directions, see doca_dpi_enqueue.
+ * @param payload_offsets
+ * Array of offsets where the packets' payload begins.
+ * @param user_data
+ * Array of private user data, NULL for no user data.
+ * @param nb_pkts
+ * Number of packets in the input arrays.
+ * @param status
+ * Output array of doca_dpi_enqueue_status_t for each handled packet,
+ * may be NULL.
+ * @return
+ * Number of packets handled, from the beginning of the arrays, error code
+ * (negative) otherwise.
+ */
+__DOCA_EXPERIMENTAL
+int doca_dpi_enqueue_burst(struct doca_dpi_flow_ctx **flow_ctxs, struct rte_mbuf **pkts,
+			   const bool *initiators, const uint32_t *payload_offsets,
+			   void **user_data, uint16_t nb_pkts, int *status);
+
+/**
+ * @brief Dequeues a burst of packets after processing.
+ *
+ * Burst variant of doca_dpi_dequeue. Packets will return in the order they
+ * were enqueued.
+ *
+ * @param ctx
+ * The DPI context.
+ * @param dpi_q
+ * The DPI queue from which to dequeue the flows' packets.
+ * @param results
+ * Output array of matching results.
+ * @param nb_results
+ * Length of the results array.
+ * @return
+ * Number of results filled, 0 if no DPI enqueued jobs done, error code
+ * (negative) otherwise.
+ */
+__DOCA_EXPERIMENTAL
+int doca_dpi_dequeue_burst(struct doca_dpi_ctx *ctx, uint16_t dpi_q,
+			   struct doca_dpi_result *results, uint16_t nb_results);
+
 /**
  * @brief Creates a new flow on a queue
  *
@@ -329,10 +634,115 @@ struct doca_dpi_flow_ctx *doca_dpi_flow_create(struct doca_dpi_ctx *ctx, uint16_
 					       int *error,
 					       struct doca_dpi_result *result);
 
+/**
+ * @brief Looks up a flow on a queue, creates it if not found
+ *
+ * Valid when max_flows_per_queue is set in doca_dpi_config_t. The queue keeps
+ * a flow table keyed by the 5-tuple of the parsing info, both directions of a
+ * connection map to the same flow. New flows are allocated from a pool of
+ * max_flows_per_queue flow contexts reserved at init, so no memory is
+ * allocated per flow. doca_dpi_flow_create also uses this pool when enabled.
+ *
+ * The flows of the table are destroyed by doca_dpi_flow_table_expire, or by
+ * doca_dpi_flow_destroy.
+ *
+ * @param ctx
+ * The DPI context.
+ * @param dpi_q
+ * The DPI queue of the flow table.
+ * @param parsing_info
+ * L3/L4 information of the packet.
+ * @param initiator
+ * Output, true if the packet is from the flow initiator, to be given to
+ * doca_dpi_enqueue.
+ * @param created
+ * Output, true if the flow was created by this call.
+ * @param error
+ * Output, Negative if error occurred, -ENOSPC if the flow table is full.
+ * @param result
+ * Output, for a created flow, if flow was matched based on the parsing info,
+ * result->matched will be true.
+ * @return
+ * NULL on error, or if the flow table is full, see error.
+ */
+__DOCA_EXPERIMENTAL
+struct doca_dpi_flow_ctx *doca_dpi_flow_lookup_or_create(struct doca_dpi_ctx *ctx, uint16_t dpi_q,
+					const struct doca_dpi_parsing_info *parsing_info,
+					bool *initiator, bool *created, int *error,
+					struct doca_dpi_result *result);
+
+/**
+ * @brief Destroys idle flows of a queue flow table
+ *
+ * Destroys the flows of the table that had no lookup for flow_idle_timeout
+ * seconds. Same as doca_dpi_flow_destroy, packets of these flows that are still
+ * processed are dequeued with DOCA_DPI_STATUS_DESTROYED.
+ *
+ * Should be called periodically from the thread of the queue.
+ *
+ * @param ctx
+ * The DPI context.
+ * @param dpi_q
+ * The DPI queue of the flow table.
+ * @param max_flows
+ * Max number of flows to destroy in this call, 0 for no limit.
+ * @return
+ * Number of flows destroyed, error code (negative) otherwise.
+ */
+__DOCA_EXPERIMENTAL
+int doca_dpi_flow_table_expire(struct doca_dpi_ctx *ctx, uint16_t dpi_q, uint32_t max_flows);
+
+/**
+ * @brief Checks if an aged doca flow entry was added by the DPI offload
+ *
+ * The doca flow queues, and the pipes of doca_dpi_offload_cfg, may also hold
+ * entries of the application. This function tells apart the entries added by
+ * the DPI in the user data returned by doca_flow_handle_aging: user_data must
+ * have DOCA_DPI_OFFLOAD_USER_DATA_FLAG set and be found in the table of the
+ * offloaded flows of the DPI queue. user_data is never dereferenced, so any
+ * application value is safe to check.
+ *
+ * @param ctx
+ * The DPI context.
+ * @param dpi_q
+ * The DPI queue, same number as the doca flow queue the entry aged on.
+ * @param user_data
+ * The user data of an aged entry, doca_flow_aged_query.user_data.
+ * @return
+ * true if the entry was added by the DPI offload, false otherwise.
+ */
+__DOCA_EXPERIMENTAL
+bool doca_dpi_flow_ctx_is_offloaded(struct doca_dpi_ctx *ctx, uint16_t dpi_q, uint64_t user_data);
+
+/**
+ * @brief Handles an aged doca flow entry of the DPI offload
+ *
+ * Should be called for each aged entry for which doca_dpi_flow_ctx_is_offloaded
+ * returns true, from the thread of the flow queue. The first entry of a flow
+ * that ages is only marked, the flow context is returned when the entry of the
+ * other direction ages too, so each flow is returned once.
+ *
+ * @param ctx
+ * The DPI context.
+ * @param dpi_q
+ * The DPI queue, same number as the doca flow queue the entry aged on.
+ * @param user_data
+ * The user data of an aged entry, doca_flow_aged_query.user_data.
+ * @return
+ * The flow context to destroy with doca_dpi_flow_destroy, NULL if the entry of
+ * the other direction is not aged yet or user_data is not a DPI entry of the
+ * queue, see doca_dpi_flow_ctx_is_offloaded.
+ */
+__DOCA_EXPERIMENTAL
+struct doca_dpi_flow_ctx *doca_dpi_flow_aged(struct doca_dpi_ctx *ctx, uint16_t dpi_q,
+					     uint64_t user_data);
+
 /**
  * @brief Destroys a flow on a queue
  *
  * Should be called when a flow is terminated or times out
+ * If the flow verdict was offloaded, the doca flow entries of the flow are
+ * removed.
  *
  * @param flow_ctx
  * The flow context to destroy.
@@ -340,6 +750,24 @@ struct doca_dpi_flow_ctx *doca_dpi_flow_create(struct doca_dpi_ctx *ctx, uint16_
 __DOCA_EXPERIMENTAL
 void doca_dpi_flow_destroy(struct doca_dpi_flow_ctx *flow_ctx);
 
+/**
+ * @brief Sets the inspection policy of a flow
+ *
+ * Overrides the default inspection policy of doca_dpi_config_t for this flow.
+ * Bytes and packets already inspected on the flow count for the new limits.
+ * Should be called from the thread of the flow queue.
+ *
+ * @param flow_ctx
+ * The flow context.
+ * @param policy
+ * Inspection policy to set.
+ * @return
+ * 0 on success, error code otherwise.
+ */
+__DOCA_EXPERIMENTAL
+int doca_dpi_flow_inspect_policy_set(struct doca_dpi_flow_ctx *flow_ctx,
+				     const struct doca_dpi_inspect_policy *policy);
+
 /**
  * @brief Query a flow's match
  *
@@ -403,6 +831,27 @@ __DOCA_EXPERIMENTAL
 void doca_dpi_stat_get(const struct doca_dpi_ctx *ctx, bool clear,
 		       struct doca_dpi_stat_info *stats);
 
+/**
+ * @brief Returns statistics of one DPI queue.
+ *
+ * The statistics are kept per queue by the queue thread and read without
+ * lock, so this function can be called from any thread without affecting
+ * packet processing. Counters of one call may not be from the exact same
+ * moment.
+ *
+ * @param ctx
+ * The DPI context.
+ * @param dpi_q
+ * The DPI queue to get the statistics of.
+ * @param stats
+ * Output struct containing the statistics.
+ * @return
+ * 0 on success, error code otherwise.
+ */
+__DOCA_EXPERIMENTAL
+int doca_dpi_queue_stat_get(const struct doca_dpi_ctx *ctx, uint16_t dpi_q,
+			    struct doca_dpi_queue_stat_info *stats);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -18,6 +18,47 @@
  * DOCA HW offload flow library. For more details please refer to the user guide
  * on DOCA devzone.
  *
+ * Multithreading:
+ *
+ * Each offload queue (pipe_queue) has its own entries state, HW queue,
+ * aging state and entry handlers cache, so the add, rm, update and aging
+ * paths take no lock. A queue must be used by one thread at a time, and an
+ * entry belongs to the queue it was added on. An entry owned by another
+ * queue is removed with doca_flow_pipe_rm_entry_handoff. Creating and
+ * destroying ports and pipes is not thread safe and should be done from one
+ * control thread.
+ *
+ * The objects shared between queues on these paths are:
+ * - the entry handlers reserve of a pipe, which the queues refill their
+ *   caches from, and the idle handlers of the queue caches, which are taken
+ *   by another queue when the reserve is empty. Both are lock free rings
+ *   updated with atomic operations.
+ * - the shared meters and shared counters referenced by entries of any
+ *   queue. Their reference counts are updated with atomic operations, their
+ *   state is updated by HW. doca_flow_shared_meter_set and
+ *   doca_flow_shared_counter_query can be called from any thread.
+ *
+ * The readers that take no queue, doca_flow_query, doca_flow_query_entries,
+ * doca_flow_query_pipe and doca_flow_pipe_iter_*, can be called from any
+ * thread while the owning queues add, remove and update entries. They take
+ * no lock shared with the queues, removed entry handlers are freed with
+ * deferred reclamation: the handler of a removed entry is freed by its queue
+ * only once no reader call that started before the removal is still
+ * running, and no iterator or query cursor still holds it as returned by
+ * its last call. So the entry handlers returned by doca_flow_pipe_iter_next
+ * and doca_flow_query_pipe stay valid, even if their queue removes them,
+ * until the next call on the same iterator or cursor or its destruction.
+ * Within that time they can be passed to doca_flow_query,
+ * doca_flow_query_entries or doca_flow_pipe_rm_entry_handoff. A handler
+ * with a pending handoff is freed only after its queue handled the handoff,
+ * and the handoff of an entry already removed is ignored. An entry removed
+ * or updated during a reader call may be returned with its old or its new
+ * state. Other handlers of entries must not be passed to a reader after
+ * they were removed.
+ *
+ * Each iterator and each query cursor must be used by one thread at a
+ * time, several threads can each use their own.
+ *
  * @{
  */
 
@@ -49,6 +90,16 @@ struct doca_flow_pipe;
  */
 struct doca_flow_pipe_entry;
 
+/**
+ * @brief doca flow pipeline entries iterator struct
+ */
+struct doca_flow_pipe_iter;
+
+/**
+ * @brief doca flow pipe query cursor struct
+ */
+struct doca_flow_query_cursor;
+
 /**
  * @brief doca flow error type define
  */
@@ -75,6 +126,8 @@ enum doca_flow_error_type {
 	/**< Out of memory */
 	DOCA_ERROR_PORT,
 	/**< Port error */
+	DOCA_ERROR_PIPE_FULL,
+	/**< Pipe reached its max number of entries */
 };
 
 /**
@@ -94,11 +147,19 @@ struct doca_flow_cfg {
 	uint32_t total_sessions;
 	/**< total flows count */
 	uint16_t queues;
-	/**< queue id for each offload thread */
+	/**< number of queues, one queue for each offload thread */
 	bool is_hairpin;
 	/**< when true, the fwd will be hairpin queue */
 	bool aging;
 	/**< when true, aging is handled by doca */
+	uint32_t queue_depth;
+	/**< max in-flight burst operations per queue, 0 for default */
+	bool aging_events;
+	/**< when true, aged flows are reported by HW events, not by scan */
+	uint32_t nb_shared_meters;
+	/**< number of shared meters */
+	uint32_t nb_shared_counters;
+	/**< number of shared counters */
 };
 
 /**
@@ -284,6 +345,10 @@ enum {
 	/**< set monitor with counter action */
 	DOCA_FLOW_MONITOR_AGING = (1 << 3),
 	/**< set monitor with aging action */
+	DOCA_FLOW_MONITOR_SHARED_METER = (1 << 4),
+	/**< set monitor with shared meter action */
+	DOCA_FLOW_MONITOR_SHARED_COUNT = (1 << 5),
+	/**< set monitor with shared counter action */
 };
 
 /**
@@ -305,6 +370,10 @@ struct doca_flow_monitor {
 	/**< aging time in seconds.*/
 	uint64_t user_data;
 	/**< aging user data input.*/
+	uint32_t shared_meter_id;
+	/**< shared meter id, see doca_flow_shared_meter_set */
+	uint32_t shared_counter_id;
+	/**< shared counter id, see doca_flow_shared_counter_query */
 };
 
 /**
@@ -325,6 +394,10 @@ struct doca_flow_pipe_cfg {
 	/**< actions for the pipeline */
 	struct doca_flow_monitor *monitor;
 	/**< monitor for the pipeline */
+	uint32_t nb_entries;
+	/**< max number of entries in the pipeline, total of all queues,
+	 *   0 for no reservation
+	 */
 };
 
 /**
@@ -337,6 +410,60 @@ struct doca_flow_query {
 	/**< total packets hit this flow */
 };
 
+/**
+ * @brief pipe entry information returned by pipe iterator
+ */
+struct doca_flow_pipe_entry_info {
+	struct doca_flow_pipe_entry *entry;
+	/**< pipe entry handler */
+	struct doca_flow_match match;
+	/**< match of the entry */
+	struct doca_flow_match match_mask;
+	/**< match mask of the entry, valid for control and acl pipes */
+	struct doca_flow_actions actions;
+	/**< actions of the entry */
+	struct doca_flow_monitor monitor;
+	/**< monitor of the entry */
+	struct doca_flow_fwd fwd;
+	/**< fwd of the entry */
+	struct doca_flow_query query;
+	/**< counters of the entry, valid if the entry is counted */
+};
+
+/**
+ * @brief flow bulk query flags
+ */
+enum doca_flow_query_flags {
+	DOCA_FLOW_QUERY_NONE = 0,
+	/**< query all entries */
+	DOCA_FLOW_QUERY_CHANGED_ONLY = (1 << 0),
+	/**< query only entries whose counters changed since the cursor last reported them */
+};
+
+/**
+ * @brief status of an entry posted by a burst operation
+ */
+enum doca_flow_entry_status {
+	DOCA_FLOW_ENTRY_STATUS_IN_PROCESS,
+	/**< entry is posted to HW, offload not done yet */
+	DOCA_FLOW_ENTRY_STATUS_SUCCESS,
+	/**< entry is offloaded to HW */
+	DOCA_FLOW_ENTRY_STATUS_ERROR,
+	/**< entry offload failed, entry must be removed */
+};
+
+/**
+ * @brief burst operation completion result
+ */
+struct doca_flow_entry_result {
+	struct doca_flow_pipe_entry *entry;
+	/**< entry handler returned when it was posted */
+	enum doca_flow_entry_status status;
+	/**< final status of the entry */
+	uint64_t user_data;
+	/**< user data given when the entry was posted */
+};
+
 /**
  * @brief aged flow query callback context
  */
@@ -444,6 +571,16 @@ doca_flow_port_priv_data(struct doca_flow_port *port);
  *
  * This API will create the pipe, but would not start the HW offload.
  *
+ * When nb_entries is set in the pipe configuration, the HW table space
+ * and the entry handlers of nb_entries entries are reserved at creation,
+ * so adding entries does no memory allocation. nb_entries is the total of
+ * the pipe, not of each queue: each queue takes handlers in batches from
+ * the pipe reserve into a small local cache, so one busy queue can use all
+ * the room of the pipe. When the pipe reserve is empty, the queue takes
+ * the idle handlers left in the caches of the other queues, lock free,
+ * before failing. So adding an entry fails with DOCA_ERROR_PIPE_FULL only
+ * when nb_entries entries are in the pipe, on all queues.
+ *
  * @param cfg
  * Pipe configuration.
  * @param fwd
@@ -481,6 +618,39 @@ struct doca_flow_pipe *
 doca_flow_create_control_pipe(struct doca_flow_port *port,
 			struct doca_flow_error *error);
 
+/**
+ * @brief Create acl pipe.
+ *
+ * Acl pipe is a priority pipe like the control pipe, each entry has its
+ * own match mask, but it is not limited in the number of entries. The
+ * entries are grouped by match mask into HW tables (tuple space), entries
+ * that only differ by ip prefix length are kept in a longest prefix match
+ * layout, so a lookup does not depend on the number of entries.
+ *
+ * Entries are added by doca_flow_acl_pipe_add_entry and removed by
+ * doca_flow_pipe_rm_entry, without rebuilding the other entries.
+ *
+ * The match_mask of the configuration defines the fields that the entries
+ * may match on, it must be a superset of all the entries masks. The
+ * actions and monitor of the configuration are not used. nb_entries is
+ * mandatory and is the max number of entries, same as for other pipes
+ * adding an entry past it fails with DOCA_ERROR_PIPE_FULL.
+ *
+ * @param cfg
+ * Pipe configuration.
+ * @param fwd_miss
+ * Fwd_miss configuration for the pipe. NULL for no fwd_miss.
+ * @param error
+ * Output error, set doca_flow_error for details.
+ * @return
+ * pipe handler or NULL on failure.
+ */
+__DOCA_EXPERIMENTAL
+struct doca_flow_pipe *
+doca_flow_create_acl_pipe(const struct doca_flow_pipe_cfg *cfg,
+			  const struct doca_flow_fwd *fwd_miss,
+			  struct doca_flow_error *error);
+
 
 /**
  * @brief Add one new entry to a pipe.
@@ -525,6 +695,178 @@ doca_flow_pipe_add_entry(uint16_t pipe_queue,
 			 const struct doca_flow_fwd *fwd,
 			 struct doca_flow_error *error);
 
+/**
+ * @brief Post a burst of new entries to a pipe.
+ *
+ * Burst variant of doca_flow_pipe_add_entry. All entries are posted to
+ * the HW on the given queue with a single doorbell, and the function
+ * returns without waiting for the HW offload to be done. The completion
+ * of each entry is reported by doca_flow_entries_process.
+ *
+ * The match array is mandatory and holds nb_entries elements. The
+ * actions, monitor, fwd and user_data arrays are optional, when NULL
+ * the pipe definition is used for all entries.
+ *
+ * The number of entries in process on one queue is limited by
+ * doca_flow_cfg.queue_depth, entries above the limit are not posted.
+ *
+ * @param pipe_queue
+ * Queue identifier.
+ * @param pipe
+ * Pointer to pipe.
+ * @param nb_entries
+ * Number of entries in the input arrays.
+ * @param match
+ * Array of match, indicate specific packet match information.
+ * @param actions
+ * Array of modify actions, indicate specific modify information.
+ * @param monitor
+ * Array of monitor actions.
+ * @param fwd
+ * Array of fwd actions.
+ * @param user_data
+ * Array of user data, returned in doca_flow_entry_result.
+ * @param entries
+ * Output array of pipe entry handlers, filled for each posted entry.
+ * @param error
+ * Output error, set doca_flow_error for details.
+ * @return
+ * Number of entries posted, from the beginning of the arrays. Posting
+ * stops on the first entry that fails validation, with error set, or when
+ * the queue is full, so the value may be less than nb_entries. The entries
+ * before it are posted and their handlers are set in entries. 0 if the
+ * queue is full before the first entry, error is not set, the application
+ * should process the queue completions and retry. Negative only if the
+ * first entry failed, error is set.
+ */
+__DOCA_EXPERIMENTAL
+int
+doca_flow_pipe_add_entries_burst(uint16_t pipe_queue,
+				 struct doca_flow_pipe *pipe,
+				 uint32_t nb_entries,
+				 const struct doca_flow_match *match,
+				 const struct doca_flow_actions *actions,
+				 const struct doca_flow_monitor *monitor,
+				 const struct doca_flow_fwd *fwd,
+				 const uint64_t *user_data,
+				 struct doca_flow_pipe_entry **entries,
+				 struct doca_flow_error *error);
+
+/**
+ * @brief Process the completions of burst operations in queue.
+ *
+ * Poll the HW completions of the entries posted on the given queue and
+ * fill the results array with the entries that are done. Should be called
+ * periodically from the thread that posted the entries, it can be
+ * interleaved with the packet processing of the same thread.
+ *
+ * An entry with DOCA_FLOW_ENTRY_STATUS_ERROR status must be freed with
+ * doca_flow_pipe_rm_entry. An entry in DOCA_FLOW_ENTRY_STATUS_IN_PROCESS
+ * status must not be removed, it should be removed once it is returned by
+ * this function.
+ *
+ * @param pipe_queue
+ * Queue identifier.
+ * @param results
+ * User input results array for the completed entries.
+ * @param len
+ * User input length of results array.
+ * @return
+ * >= 0 the number of completed entries filled in results array.
+ * Negative on failure.
+ */
+__DOCA_EXPERIMENTAL
+int
+doca_flow_entries_process(uint16_t pipe_queue,
+			  struct doca_flow_entry_result *results, int len);
+
+/**
+ * @brief Get the status of a pipe entry.
+ *
+ * @param entry
+ * The pipe entry to query.
+ * @return
+ * Entry status, see doca_flow_entry_status.
+ */
+__DOCA_EXPERIMENTAL
+enum doca_flow_entry_status
+doca_flow_pipe_entry_get_status(struct doca_flow_pipe_entry *entry);
+
+/**
+ * @brief Get the size of the match key of a pipe.
+ *
+ * When a pipe is created, its match and match_mask are compiled into a
+ * packed match key that holds only the fields the pipe matches on. The
+ * fields are in the order of doca_flow_match, in network byte order and
+ * with no padding. An ip address takes 4 bytes for ipv4 and 16 bytes for
+ * ipv6, as defined by the pipe match. The flags field is not part of the
+ * key.
+ *
+ * @param pipe
+ * Pointer to pipe.
+ * @return
+ * Match key size in bytes.
+ */
+__DOCA_EXPERIMENTAL
+uint32_t
+doca_flow_pipe_match_key_size(struct doca_flow_pipe *pipe);
+
+/**
+ * @brief Build the match key of a pipe from a packet.
+ *
+ * Parse the packet headers and copy the fields the pipe matches on into
+ * the key, the fields that are not matched by the pipe are not parsed.
+ *
+ * @param pipe
+ * Pointer to pipe.
+ * @param pkt
+ * Pointer to the packet, starting at the outer Ethernet header.
+ * @param pkt_len
+ * Length of the packet headers.
+ * @param key
+ * Output key buffer of doca_flow_pipe_match_key_size bytes.
+ * @return
+ * 0 on success, negative if the packet does not hold all pipe fields.
+ */
+__DOCA_EXPERIMENTAL
+int
+doca_flow_pipe_match_key_from_pkt(struct doca_flow_pipe *pipe,
+				  const uint8_t *pkt, uint32_t pkt_len,
+				  uint8_t *key);
+
+/**
+ * @brief Add one new entry to a pipe by match key.
+ *
+ * Refer to doca_flow_pipe_add_entry. The match is given as the packed
+ * match key of the pipe, see doca_flow_pipe_match_key_size, so there is
+ * no translation of the full doca_flow_match on insertion.
+ *
+ * @param pipe_queue
+ * Queue identifier.
+ * @param pipe
+ * Pointer to pipe.
+ * @param key
+ * Pointer to match key of doca_flow_pipe_match_key_size bytes.
+ * @param actions
+ * Pointer to modify actions, indicate specific modify information.
+ * @param monitor
+ * Pointer to monitor actions.
+ * @param fwd
+ * Pointer to fwd actions.
+ * @param error
+ * Output error, set doca_flow_error for details.
+ * @return
+ * Pipe entry handler on success, NULL otherwise and error is set.
+ */
+__DOCA_EXPERIMENTAL
+struct doca_flow_pipe_entry*
+doca_flow_pipe_add_entry_by_key(uint16_t pipe_queue,
+				struct doca_flow_pipe *pipe,
+				const uint8_t *key,
+				const struct doca_flow_actions *actions,
+				const struct doca_flow_monitor *monitor,
+				const struct doca_flow_fwd *fwd,
+				struct doca_flow_error *error);
 
 /**
  * @brief Add one new entry to a control pipe.
@@ -558,6 +900,39 @@ doca_flow_control_pipe_add_entry(uint16_t pipe_queue,
 			const struct doca_flow_fwd *fwd,
 			struct doca_flow_error *error);
 
+/**
+ * @brief Add one new entry to an acl pipe.
+ *
+ * Refer to doca_flow_control_pipe_add_entry. When a packet matches more
+ * than one entry, the entry with the lowest priority value is used.
+ *
+ * @param pipe_queue
+ * Queue identifier.
+ * @param priority
+ * Priority value, lower value is higher priority.
+ * @param pipe
+ * Pointer to pipe.
+ * @param match
+ * Pointer to match, indicate specific packet match information.
+ * @param match_mask
+ * Pointer to match mask information.
+ * @param fwd
+ * Pointer to fwd actions.
+ * @param error
+ * Output error, set doca_flow_error for details.
+ * @return
+ * Pipe entry handler on success, NULL otherwise and error is set.
+ */
+__DOCA_EXPERIMENTAL
+struct doca_flow_pipe_entry*
+doca_flow_acl_pipe_add_entry(uint16_t pipe_queue,
+			uint32_t priority,
+			struct doca_flow_pipe *pipe,
+			const struct doca_flow_match *match,
+			const struct doca_flow_match *match_mask,
+			const struct doca_flow_fwd *fwd,
+			struct doca_flow_error *error);
+
 /**
  * @brief Free one pipe entry.
  *
@@ -565,6 +940,9 @@ doca_flow_control_pipe_add_entry(uint16_t pipe_queue,
  * Application receives the entry pointer upon creation and if can
  * call this function when there is no more need for this offload.
  * For example, if the entry aged, use this API to free it.
+ * An entry posted by doca_flow_pipe_add_entries_burst must not be removed
+ * while its status is DOCA_FLOW_ENTRY_STATUS_IN_PROCESS, this function
+ * fails with -EBUSY in that case.
  *
  * @param pipe_queue
  * Queue identifier.
@@ -578,6 +956,79 @@ int
 doca_flow_pipe_rm_entry(uint16_t pipe_queue,
 			struct doca_flow_pipe_entry *entry);
 
+/**
+ * @brief Hand off the removal of a pipe entry to its queue.
+ *
+ * Used to remove an entry that was added on another queue, without taking
+ * a lock shared between queues. The removal request is pushed to a lock
+ * free ring of the queue owning the entry, and the entry is removed by
+ * that queue on its next call to doca_flow_entries_process,
+ * doca_flow_handle_aging or doca_flow_handle_aging_events. The entry must
+ * not be used by the caller after this call. If the owning queue removed the
+ * entry before handling the request, the request is ignored.
+ *
+ * @param pipe_queue
+ * Queue identifier of the caller.
+ * @param entry
+ * The pipe entry to be removed.
+ * @return
+ * 0 on success, negative on failure, -EAGAIN if the ring of the owning
+ * queue is full.
+ */
+__DOCA_EXPERIMENTAL
+int
+doca_flow_pipe_rm_entry_handoff(uint16_t pipe_queue,
+				struct doca_flow_pipe_entry *entry);
+
+/**
+ * @brief Get the queue owning a pipe entry.
+ *
+ * @param entry
+ * The pipe entry.
+ * @return
+ * Queue identifier the entry was added on.
+ */
+__DOCA_EXPERIMENTAL
+uint16_t
+doca_flow_pipe_entry_get_queue(struct doca_flow_pipe_entry *entry);
+
+/**
+ * @brief Update one pipe entry.
+ *
+ * Replace the actions, monitor and/or fwd of an existing entry, the match
+ * of the entry is not changed. The update is done as one atomic HW
+ * operation, packets hit either the old or the new configuration and never
+ * go to the pipe miss path during the update.
+ *
+ * Parameters given as NULL are kept as they are. The actions, monitor and
+ * fwd must follow the pipe definition, same as doca_flow_pipe_add_entry.
+ * The counter of the entry is kept. Setting a new meter cir/cbs does not
+ * reset the meter state of the entry.
+ *
+ * @param pipe_queue
+ * Queue identifier.
+ * @param entry
+ * The pipe entry to be updated.
+ * @param actions
+ * Pointer to new modify actions, NULL to keep.
+ * @param monitor
+ * Pointer to new monitor actions, NULL to keep.
+ * @param fwd
+ * Pointer to new fwd actions, NULL to keep.
+ * @param error
+ * Output error, set doca_flow_error for details.
+ * @return
+ * 0 on success, negative on failure and error is set.
+ */
+__DOCA_EXPERIMENTAL
+int
+doca_flow_pipe_update_entry(uint16_t pipe_queue,
+			    struct doca_flow_pipe_entry *entry,
+			    const struct doca_flow_actions *actions,
+			    const struct doca_flow_monitor *monitor,
+			    const struct doca_flow_fwd *fwd,
+			    struct doca_flow_error *error);
+
 /**
  * @brief Destroy one pipe
  *
@@ -631,6 +1082,75 @@ __DOCA_EXPERIMENTAL
 void
 doca_flow_dump_pipe(uint16_t port_id, FILE *f);
 
+/**
+ * @brief Create an iterator over the entries of one pipe
+ *
+ * Unlike doca_flow_dump_pipe, the iterator does not go over all entries
+ * in one call. The entries are returned by doca_flow_pipe_iter_next
+ * within a time quota, and the iterator keeps its position between calls,
+ * so the datapath is not stopped while a large pipe is read.
+ *
+ * When filter is given, only the entries that match the filter fields
+ * selected by filter_mask are returned.
+ *
+ * Entries added after the iterator was created may or may not be returned.
+ * Removed entries are not returned.
+ *
+ * @param pipe
+ * Pointer to pipe.
+ * @param filter
+ * Pointer to match filter, NULL to return all entries.
+ * @param filter_mask
+ * Pointer to mask of the match filter.
+ * @param error
+ * Output error, set doca_flow_error for details.
+ * @return
+ * Iterator handler on success, NULL otherwise and error is set.
+ */
+__DOCA_EXPERIMENTAL
+struct doca_flow_pipe_iter *
+doca_flow_pipe_iter_create(struct doca_flow_pipe *pipe,
+			   const struct doca_flow_match *filter,
+			   const struct doca_flow_match *filter_mask,
+			   struct doca_flow_error *error);
+
+/**
+ * @brief Get the next entries of a pipe iterator
+ *
+ * Fill the infos array with the next entries of the pipe, including their
+ * counters. Same as doca_flow_handle_aging, this function is limited by
+ * time quota and should be called again until it returns -1.
+ *
+ * @param iter
+ * Pointer to iterator.
+ * @param quota
+ * Max time quota in micro seconds for this function to go over entries.
+ * @param infos
+ * User input array for the entries information.
+ * @param len
+ * User input length of infos array.
+ * @return
+ * > 0 the number of entries filled in infos array.
+ * 0 no entries filled in current call.
+ * -1 all entries were returned.
+ */
+__DOCA_EXPERIMENTAL
+int
+doca_flow_pipe_iter_next(struct doca_flow_pipe_iter *iter, uint64_t quota,
+			 struct doca_flow_pipe_entry_info *infos, int len);
+
+/**
+ * @brief Destroy a pipe iterator
+ *
+ * Must be called before the pipe is destroyed.
+ *
+ * @param iter
+ * Pointer to iterator.
+ */
+__DOCA_EXPERIMENTAL
+void
+doca_flow_pipe_iter_destroy(struct doca_flow_pipe_iter *iter);
+
 /**
  * @brief Extract information about specific entry
  *
@@ -648,6 +1168,140 @@ int
 doca_flow_query(struct doca_flow_pipe_entry *entry,
 		struct doca_flow_query *query_stats);
 
+/**
+ * @brief Set one shared meter.
+ *
+ * Shared meter is created once and referenced by the monitor of many
+ * entries using DOCA_FLOW_MONITOR_SHARED_METER, all the packets of these
+ * entries are policed by the same meter. Can be called again to change
+ * the rate of the meter, the entries referencing it are not changed.
+ *
+ * @param shared_meter_id
+ * Shared meter id, less than doca_flow_cfg.nb_shared_meters.
+ * @param cir
+ * Committed Information Rate (bytes/second).
+ * @param cbs
+ * Committed Burst Size (bytes).
+ * @param error
+ * Output error, set doca_flow_error for details.
+ * @return
+ * 0 on success, negative on failure and error is set.
+ */
+__DOCA_EXPERIMENTAL
+int
+doca_flow_shared_meter_set(uint32_t shared_meter_id, uint64_t cir, uint64_t cbs,
+			   struct doca_flow_error *error);
+
+/**
+ * @brief Extract information about one shared counter
+ *
+ * Shared counter is referenced by the monitor of many entries using
+ * DOCA_FLOW_MONITOR_SHARED_COUNT, the packets of all these entries are
+ * counted in one HW counter.
+ *
+ * @param shared_counter_id
+ * Shared counter id, less than doca_flow_cfg.nb_shared_counters.
+ * @param query_stats
+ * Data retrieved by the query.
+ * @return
+ * 0 on success, negative on failure.
+ */
+__DOCA_EXPERIMENTAL
+int
+doca_flow_shared_counter_query(uint32_t shared_counter_id,
+			       struct doca_flow_query *query_stats);
+
+/**
+ * @brief Extract information about many entries
+ *
+ * Bulk variant of doca_flow_query. The counters of all the entries are
+ * read from HW in batches, and query_stats[i] is filled with the
+ * statistics of entries[i].
+ *
+ * @param entries
+ * Array of pipe entries to query.
+ * @param nb_entries
+ * Number of entries in the entries array.
+ * @param query_stats
+ * Output array of nb_entries elements, data retrieved by the query.
+ * @return
+ * 0 on success, negative on failure.
+ */
+__DOCA_EXPERIMENTAL
+int
+doca_flow_query_entries(struct doca_flow_pipe_entry **entries, int nb_entries,
+			struct doca_flow_query *query_stats);
+
+/**
+ * @brief Create a query cursor over the counted entries of one pipe
+ *
+ * The cursor holds the position of doca_flow_query_pipe in the pipe and,
+ * with DOCA_FLOW_QUERY_CHANGED_ONLY, the counters last reported for each
+ * entry. Several users of the same pipe, for example an exporter and a
+ * reconciler, each create their own cursor and get their own deltas.
+ *
+ * @param pipe
+ * Pointer to pipe.
+ * @param flags
+ * Query flags, see doca_flow_query_flags.
+ * @param error
+ * Output error, set doca_flow_error for details.
+ * @return
+ * Cursor handler on success, NULL otherwise and error is set.
+ */
+__DOCA_EXPERIMENTAL
+struct doca_flow_query_cursor *
+doca_flow_query_cursor_create(struct doca_flow_pipe *pipe, uint32_t flags,
+			      struct doca_flow_error *error);
+
+/**
+ * @brief Destroy a query cursor
+ *
+ * Must be called before the pipe is destroyed.
+ *
+ * @param cursor
+ * Pointer to query cursor.
+ */
+__DOCA_EXPERIMENTAL
+void
+doca_flow_query_cursor_destroy(struct doca_flow_query_cursor *cursor);
+
+/**
+ * @brief Extract information about the entries of a pipe
+ *
+ * Go over the counted entries of the cursor pipe, read their counters
+ * from HW in batches and fill the entries and query_stats arrays, element
+ * i of query_stats belongs to element i of entries.
+ *
+ * With DOCA_FLOW_QUERY_CHANGED_ONLY flag set on the cursor, only the
+ * entries whose counters changed since they were last reported through
+ * this cursor are filled.
+ *
+ * Same as doca_flow_handle_aging, this function is limited by time quota
+ * and should be called again until a full cycle is done, in which case
+ * it will return -1, the next call starts a new cycle.
+ *
+ * @param cursor
+ * Pointer to query cursor.
+ * @param quota
+ * Max time quota in micro seconds for this function to handle the query.
+ * @param entries
+ * User input array for the queried entries.
+ * @param query_stats
+ * User input array for the data retrieved by the query.
+ * @param len
+ * User input length of entries and query_stats arrays.
+ * @return
+ * > 0 the number of entries filled in the arrays.
+ * 0 no entries filled in current call.
+ * -1 full cycle done.
+ */
+__DOCA_EXPERIMENTAL
+int
+doca_flow_query_pipe(struct doca_flow_query_cursor *cursor, uint64_t quota,
+		     struct doca_flow_pipe_entry **entries,
+		     struct doca_flow_query *query_stats, int len);
+
 /**
  * @brief Handle aging of flows in queue.
  *
@@ -679,6 +1333,52 @@ int
 doca_flow_handle_aging(uint16_t queue, uint64_t quota,
 		       struct doca_flow_aged_query *entries, int len);
 
+/**
+ * @brief Handle aging events of flows in queue.
+ *
+ * Event based variant of doca_flow_handle_aging, valid when
+ * doca_flow_cfg.aging_events is set. The HW reports each flow once its
+ * aging time expired, so only the aged flows are handled and the cost of
+ * this function depends on the number of expirations, not on the number
+ * of tracked flows. The aged flows are released from being tracked and
+ * the entries array is filled with them.
+ *
+ * If more aged flows are pending than len, the function should be called
+ * again.
+ *
+ * @param queue
+ * Queue identifier.
+ * @param entries
+ * User input entries array for the aged flows.
+ * @param len
+ * User input length of entries array.
+ * @return
+ * >= 0 the number of aged flows filled in entries array.
+ * Negative on failure.
+ */
+__DOCA_EXPERIMENTAL
+int
+doca_flow_handle_aging_events(uint16_t queue,
+			      struct doca_flow_aged_query *entries, int len);
+
+/**
+ * @brief Get aging event fd of queue.
+ *
+ * Valid when doca_flow_cfg.aging_events is set. The returned file
+ * descriptor becomes readable when aged flows are pending on the queue,
+ * so it can be added to epoll instead of polling
+ * doca_flow_handle_aging_events. The fd is owned by doca flow and is
+ * closed by doca_flow_destroy.
+ *
+ * @param queue
+ * Queue identifier.
+ * @return
+ * File descriptor on success, negative on failure.
+ */
+__DOCA_EXPERIMENTAL
+int
+doca_flow_aging_event_fd(uint16_t queue);
+
 /** @} */
 
 #ifdef __cplusplus
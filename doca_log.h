@@ -32,6 +32,7 @@ extern "C" {
 
 #include <stdio.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 /**
  * @brief log levels
@@ -49,6 +50,33 @@ enum DOCA_LOG_LEVEL {
  */
 struct doca_logger_backend;
 
+/**
+ * @brief Max number of log sources with an inline level check
+ */
+#define DOCA_LOG_MAX_SOURCES 1024
+
+/**
+ * @brief Effective log level of each log source
+ *
+ * Level of the source set by doca_log_source_level_set, or for a source without
+ * its own level the highest level shown by at least one logger backend. It is
+ * updated by the library when a level is set, and should not be written by the user.
+ */
+extern uint8_t doca_log_source_level[DOCA_LOG_MAX_SOURCES];
+
+/**
+ * @brief Per call site rate limit state, see DOCA_LOG_RATE_LIMIT
+ *
+ * Shared by all the threads logging from the call site, the fields are only
+ * accessed by the library with relaxed atomics.
+ */
+struct doca_log_rate_limit {
+	uint64_t window_start;		  /**< Start time of the current one second window */
+	uint32_t count;			  /**< Number of logs in the current window */
+	uint32_t suppressed;		  /**< Number of suppressed logs not reported yet */
+	struct doca_log_rate_limit *next; /**< Library list of sites with suppressed logs */
+};
+
 /**
  * @brief logging backend flush() handler
  */
@@ -115,6 +143,91 @@ uint32_t doca_log_global_level_get(void);
  */
 int doca_log_source_register(const char *source_name);
 
+/**
+ * @brief Set the log level of a log source.
+ *
+ * Dynamically change the log level of one log source. The source level overrides
+ * the global and the backends levels for this source only: any log of this source
+ * under this level is shown by all the backends, and logs above it are not shown.
+ * For example a DEBUG level on "DPI::Parser" shows its debug logs while the other
+ * sources keep the backends levels. By default a source has no level of its own
+ * and follows the global and the backends levels.
+ *
+ * @param source
+ * The log source identifier defined by doca_log_source_register.
+ * @param level
+ * Log level enum DOCA_LOG_LEVEL.
+ * @return
+ * 0 on success, error code otherwise.
+ */
+int doca_log_source_level_set(int source, uint32_t level);
+
+/**
+ * @brief Get the log level of a log source.
+ *
+ * @param source
+ * The log source identifier defined by doca_log_source_register.
+ * @return
+ * Log level enum DOCA_LOG_LEVEL
+ */
+uint32_t doca_log_source_level_get(int source);
+
+/**
+ * @brief Check if a log level of a log source is shown.
+ *
+ * Used by DOCA_LOG before evaluating the log arguments.
+ *
+ * @param level
+ * Log level enum DOCA_LOG_LEVEL.
+ * @param source
+ * The log source identifier defined by doca_log_source_register.
+ * @return
+ * true if the log may be shown.
+ */
+static inline bool doca_log_level_enabled(uint32_t level, int source)
+{
+	if ((uint32_t)source >= DOCA_LOG_MAX_SOURCES)
+		return true;
+	return level <= doca_log_source_level[source];
+}
+
+/**
+ * @brief Check the rate limit of a log call site.
+ *
+ * Allows up to rate logs per second from the call site, for all the threads
+ * together. When a new second starts after logs were suppressed, the next
+ * check of the site generates a log with the number of suppressed logs. If the
+ * site does not log again, the count is reported by doca_log_rate_limit_flush,
+ * which the user must call periodically in synchronous mode.
+ * Lock free, when threads race on a window change a few logs over rate may be
+ * generated.
+ * This should not be used, please prefer using DOCA_LOG_RATE_LIMIT.
+ *
+ * @param rate_limit
+ * Rate limit state of the call site.
+ * @param rate
+ * Max number of logs per second.
+ * @param level
+ * Log level enum DOCA_LOG_LEVEL.
+ * @param source
+ * The log source identifier defined by doca_log_source_register.
+ * @return
+ * true if the log should be generated.
+ */
+bool doca_log_rate_limit_check(struct doca_log_rate_limit *rate_limit, uint32_t rate,
+			       uint32_t level, int source);
+
+/**
+ * @brief Report the pending suppressed logs of all rate limited call sites.
+ *
+ * Generates a log with the number of suppressed logs for each call site whose
+ * suppressed logs were not reported yet. Called by the library once a second
+ * from the asynchronous logging thread, and by doca_log_async_stop. In
+ * synchronous mode it is not called by the library, the user should call it
+ * periodically, for example once a second, from any thread.
+ */
+void doca_log_rate_limit_flush(void);
+
 /**
  * @brief Create a logging backend with a FILE* stream.
  *
@@ -156,6 +269,45 @@ struct doca_logger_backend *doca_log_create_fd_backend(int fd);
  */
 struct doca_logger_backend *doca_log_create_buffer_backend(char *buffer, size_t capacity, log_flush_callback handler);
 
+/**
+ * @brief Start asynchronous logging.
+ *
+ * Once started, doca_log() does not format nor write the log. It stores the format
+ * pointer, the raw arguments and a TSC timestamp in a lock free ring of the calling
+ * thread, and a background thread formats the records and writes them to all logger
+ * backends. Each thread gets its own ring on its first log.
+ *
+ * The format must stay valid for the life of the process, which is the case for the
+ * string literals given to DOCA_LOG. String arguments are copied to the ring, up to
+ * 256 chars each. Critical logs are still written by the calling thread, after the
+ * records pending in its ring.
+ *
+ * When a ring is full, the log is dropped and counted, the caller never waits.
+ *
+ * @param ring_size
+ * Size in bytes of the ring of each thread.
+ * @return
+ * 0 on success, error code otherwise.
+ */
+int doca_log_async_start(size_t ring_size);
+
+/**
+ * @brief Stop asynchronous logging.
+ *
+ * Reports the pending suppressed logs of the rate limited call sites, writes all
+ * the records pending in the rings, stops the background thread and frees the
+ * rings. Following logs are written by the calling thread.
+ */
+void doca_log_async_stop(void);
+
+/**
+ * @brief Get the number of logs dropped by asynchronous logging.
+ *
+ * @return
+ * Number of logs dropped since doca_log_async_start because a ring was full.
+ */
+uint64_t doca_log_async_dropped_get(void);
+
 /**
  * @brief Generates a log message.
  *
@@ -177,14 +329,41 @@ void doca_log(uint32_t level, uint32_t source, const char *format, ...);
  * The DOCA_LOG() is the main log function for logging. This call affects the performance.
  * Consider using DOCA_DLOG for the option to remove it on the final compilation.
  * Consider using the specific level DOCA_LOG for better code readability (i.e. DOCA_LOG_ERR)
+ * When the level is not shown for the log source, the arguments are not evaluated.
+ *
+ * @param level
+ * Log level enum DOCA_LOG_LEVEL (just ERROR, WARNING...).
+ * @param format
+ * printf(3) arguments, format and variables.
+ */
+#define DOCA_LOG(level, format...)                                         \
+	do {                                                               \
+		if (doca_log_level_enabled(DOCA_LOG_LEVEL_##level, log_id)) \
+			doca_log(DOCA_LOG_LEVEL_##level, log_id, format);  \
+	} while (0)
+
+/**
+ * @brief Generates a rate limited log message.
+ *
+ * Same as DOCA_LOG, generates up to rate logs per second from this call site,
+ * for all the threads together. The following logs in the same second are
+ * counted and reported once, see doca_log_rate_limit_check.
  *
  * @param level
  * Log level enum DOCA_LOG_LEVEL (just ERROR, WARNING...).
+ * @param rate
+ * Max number of logs per second.
  * @param format
  * printf(3) arguments, format and variables.
  */
-#define DOCA_LOG(level, format...)                         \
-	doca_log(DOCA_LOG_LEVEL_##level, log_id, format)   \
+#define DOCA_LOG_RATE_LIMIT(level, rate, format...)                                    \
+	do {                                                                           \
+		static struct doca_log_rate_limit doca_log_rl_site;                    \
+		if (doca_log_level_enabled(DOCA_LOG_LEVEL_##level, log_id) &&           \
+		    doca_log_rate_limit_check(&doca_log_rl_site, rate,                 \
+					      DOCA_LOG_LEVEL_##level, log_id))         \
+			doca_log(DOCA_LOG_LEVEL_##level, log_id, format);              \
+	} while (0)
 
 /**
  * @brief Generates a CRITICAL log message.
@@ -24,8 +24,9 @@
  * After creating the conf file and invoking the init function, the lib's send function
  * can be called with netflow struct to send a netflow packet with the format
  * to the collector of choice, as specified in the conf file.
- * The lib uses the netflow protocol specified by cisco.
+ * The lib uses the netflow protocol specified by cisco, or IPFIX.
  * @see https://netflow.caligare.com/netflow_v9.htm
+ * @see https://datatracker.ietf.org/doc/html/rfc7011
  *
  * Conf File structure:
  *
@@ -37,7 +38,17 @@
  *
  * source_id = <ID = integer>
  *
- * version = <version = 9>
+ * version = <version = 9/10>
+ *
+ * mtu = <bytes = integer, version 10 only>
+ *
+ * template_timeout = <seconds = integer, version 10 only>
+ *
+ *
+ * version 10 is IPFIX. In IPFIX mode records are packed into each packet up to
+ * mtu bytes (default 1500) instead of 30 records, fields are sent with their
+ * actual length when marked as variable length, and the templates are sent
+ * again every template_timeout seconds (default 600).
  *
  *
  * doca_netflow_default.conf
@@ -53,7 +64,9 @@
  *
  * Limitations:
  *
- * The lib supports the netflow V9 format. The lib is not thread safe.
+ * The lib supports the netflow V9 and IPFIX (V10) formats. The lib is not
+ * thread safe, except for the record rings: each ring has a single producer
+ * thread, and several threads can each use their own ring.
  *
  * @{
  */
@@ -110,12 +123,22 @@ struct doca_netflow_default_record {
 	/**< Name associated with a classification*/
 } __attribute__((packed));
 
+/**
+ * @brief Field flag, the field is variable length (IPFIX only).
+ *
+ * The field still takes 'length' bytes in the record, it holds a string padded
+ * with zeros and is sent with the length of the string.
+ */
+#define DOCA_NETFLOW_FIELD_FLAG_VARIABLE_LENGTH (1 << 0)
+
 /**
  * @brief One field in netflow template, please look at doca_netflow_types for type macros
  */
 struct doca_netflow_flowset_field {
-	int type;   /**< field number id (see link) - will be converted to uint16 */
-	int length; /**< field len in bytes (see link) - will be converted to uint16 */
+	int type;		    /**< field number id (see link) - will be converted to uint16 */
+	int length;		    /**< field len in bytes (see link) - will be converted to uint16 */
+	int flags;		    /**< DOCA_NETFLOW_FIELD_FLAG_* flags */
+	uint32_t enterprise_number; /**< IPFIX enterprise number, 0 for IANA fields */
 };
 
 /**
@@ -139,6 +162,11 @@ struct doca_netflow_template {
 	struct doca_netflow_flowset_field *fields; /**< array of field info */
 };
 
+/**
+ * @brief Record ring, single producer ring of packed records of one template.
+ */
+struct doca_netflow_ring;
+
 /**
  * @brief Return a default doca_netflow_template for use in send function,
  * if using default template use doca_netflow_default_record struct for records.
@@ -182,14 +210,233 @@ int doca_netflow_exporter_init(const char *netflow_conf_file);
  * again with the remaining records. Please reffer to the example.
  * @note When sending more then 30 records the lib splits the records
  * to multiple packets because a single packet can only send up to 30 records
- * (Netflow protocol limit)
+ * (Netflow protocol limit). In IPFIX mode the records are split by mtu.
  */
 __DOCA_EXPERIMENTAL
 int doca_netflow_exporter_send(const struct doca_netflow_template *netflow_template, const void **records,
 			       size_t length, int *error);
 
+/**
+ * @brief Create a record ring. Need to init first.
+ *
+ * The records are written in place into the ring by the producer thread with
+ * doca_netflow_ring_reserve and doca_netflow_ring_commit. A background exporter
+ * thread, started on the first ring creation, packs the committed records into
+ * packets of up to 30 records (or mtu bytes in IPFIX mode), sends them and
+ * retries partial sends, so the producer never waits on the socket.
+ *
+ * @param netflow_template
+ *   Template of the ring records, must stay valid until the ring is destroyed.
+ * @param nb_records
+ *   Ring size in records.
+ * @return
+ *   Ring pointer on success, NULL on error.
+ */
+__DOCA_EXPERIMENTAL
+struct doca_netflow_ring *
+doca_netflow_ring_create(const struct doca_netflow_template *netflow_template,
+			 size_t nb_records);
+
+/**
+ * @brief Reserve one record in the ring.
+ *
+ * The record has the size of the ring template fields, it must be written
+ * packed and in network byte order, then committed with doca_netflow_ring_commit.
+ * Only one record can be reserved at a time.
+ *
+ * @param ring
+ *   Record ring.
+ * @return
+ *   Pointer to the record, NULL if the ring is full.
+ */
+__DOCA_EXPERIMENTAL
+void *doca_netflow_ring_reserve(struct doca_netflow_ring *ring);
+
+/**
+ * @brief Commit the reserved record, it will be sent by the exporter thread.
+ *
+ * @param ring
+ *   Record ring.
+ */
+__DOCA_EXPERIMENTAL
+void doca_netflow_ring_commit(struct doca_netflow_ring *ring);
+
+/**
+ * @brief Request the exporter thread to send the committed records now.
+ *
+ * By default the exporter thread waits for a full packet of records, or for a
+ * short timeout, before sending.
+ *
+ * @param ring
+ *   Record ring.
+ */
+__DOCA_EXPERIMENTAL
+void doca_netflow_ring_flush(struct doca_netflow_ring *ring);
+
+/**
+ * @brief Get the number of records that could not be reserved since the ring
+ * was created, since the ring was full.
+ *
+ * @param ring
+ *   Record ring.
+ * @return
+ *   Number of dropped records.
+ */
+__DOCA_EXPERIMENTAL
+uint64_t doca_netflow_ring_dropped_get(const struct doca_netflow_ring *ring);
+
+/**
+ * @brief Send the remaining records of the ring and free it.
+ *
+ * @param ring
+ *   Record ring to destroy.
+ */
+__DOCA_EXPERIMENTAL
+void doca_netflow_ring_destroy(struct doca_netflow_ring *ring);
+
+/**
+ * @brief Flow cache, aggregates packets into default records per flow.
+ */
+struct doca_netflow_cache;
+
+/**
+ * @brief Flow cache configuration.
+ */
+struct doca_netflow_cache_cfg {
+	uint32_t nb_flows;		/**< Max number of flows in the cache */
+	uint32_t active_timeout;	/**< Seconds after which an active flow is exported */
+	uint32_t inactive_timeout;	/**< Seconds without packets after which a flow is exported */
+	uint32_t sampling_rate;		/**< 1:N packet sampling, 0 or 1 for no sampling */
+	struct doca_netflow_ring *ring;	/**< Ring of the default template for the records,
+					 *   NULL to send with doca_netflow_exporter_send
+					 */
+};
+
+/**
+ * @brief Flow cache key, the 5-tuple and input interface of a flow.
+ *
+ * The cache hashes and compares only the address bytes selected by
+ * ip_version, so for IPV4 keys the rest of the address unions do not need to
+ * be cleared.
+ *
+ * @note all fields are in network byte order.
+ */
+struct doca_netflow_flow_key {
+	uint8_t ip_version;		/**< 4 for IPV4 addresses, 6 for IPV6 addresses */
+	uint8_t protocol;		/**< IP protocol type */
+	__be16 src_port;		/**< TCP/UDP source port number or equivalent */
+	__be16 dst_port;		/**< TCP/UDP destination port number or equivalent */
+	__be16 input;			/**< Input interface index */
+	union {
+		__be32 v4;		/**< IPV4 Address */
+		struct in6_addr v6;	/**< IPV6 Address */
+	} src_addr;			/**< Source Address */
+	union {
+		__be32 v4;		/**< IPV4 Address */
+		struct in6_addr v6;	/**< IPV6 Address */
+	} dst_addr;			/**< Destination Address */
+};
+
+/**
+ * @brief Create a flow cache. Need to init first.
+ *
+ * The cache keeps one doca_netflow_default_record per flow key, accumulates
+ * d_pkts and d_octets, ORs the tcp_flags and tracks first and last. A flow is
+ * exported when it had no packets for inactive_timeout seconds, every
+ * active_timeout seconds while it is active, when it ends, or when the cache is
+ * full. An exported active flow stays in the cache with zeroed counters.
+ *
+ * d_pkts and d_octets are 32 bits, so a flow is also exported early, before an
+ * update makes one of them go over UINT32_MAX, and the update is counted in the
+ * zeroed record. The counters never wrap, a busy flow is just exported more
+ * often than every active_timeout seconds.
+ *
+ * A cache must be used by a single thread.
+ *
+ * @param cfg
+ *   Cache configuration.
+ * @return
+ *   Cache pointer on success, NULL on error.
+ */
+__DOCA_EXPERIMENTAL
+struct doca_netflow_cache *doca_netflow_cache_create(const struct doca_netflow_cache_cfg *cfg);
+
+/**
+ * @brief Update a flow of the cache with one packet.
+ *
+ * With sampling, only one of sampling_rate packets is counted, and its
+ * counters are multiplied by sampling_rate.
+ *
+ * @param cache
+ *   Flow cache.
+ * @param key
+ *   Flow key of the packet.
+ * @param pkt_len
+ *   Packet length in bytes.
+ * @param tcp_flags
+ *   TCP flags of the packet, 0 if not TCP. A FIN or RST flag ends the flow.
+ * @return
+ *   0 on success, error code otherwise.
+ */
+__DOCA_EXPERIMENTAL
+int doca_netflow_cache_pkt_update(struct doca_netflow_cache *cache,
+				  const struct doca_netflow_flow_key *key, uint32_t pkt_len,
+				  uint8_t tcp_flags);
+
+/**
+ * @brief Update a flow of the cache with counters.
+ *
+ * Used to feed the cache from HW counters, for example from doca_flow_query
+ * on entries returned by doca_flow_handle_aging. The counters are added to the
+ * flow, sampling is not applied. Same as for packets, the flow is exported
+ * before its 32 bits counters overflow. Increments over UINT32_MAX are split
+ * into several exported records of the flow, so they are not truncated.
+ *
+ * @param cache
+ *   Flow cache.
+ * @param key
+ *   Flow key.
+ * @param pkts
+ *   Number of packets to add to the flow.
+ * @param bytes
+ *   Number of bytes to add to the flow.
+ * @param ended
+ *   True if the flow ended, for example if its entry aged, to export it now.
+ * @return
+ *   0 on success, error code otherwise.
+ */
+__DOCA_EXPERIMENTAL
+int doca_netflow_cache_counters_update(struct doca_netflow_cache *cache,
+				       const struct doca_netflow_flow_key *key, uint64_t pkts,
+				       uint64_t bytes, bool ended);
+
+/**
+ * @brief Export the flows of the cache that reached their timeouts.
+ *
+ * Should be called periodically, at least every second, by the thread of the
+ * cache.
+ *
+ * @param cache
+ *   Flow cache.
+ * @return
+ *   Number of records exported, -1 on error.
+ */
+__DOCA_EXPERIMENTAL
+int doca_netflow_cache_expire(struct doca_netflow_cache *cache);
+
+/**
+ * @brief Export all the flows of the cache and free it.
+ *
+ * @param cache
+ *   Flow cache to destroy.
+ */
+__DOCA_EXPERIMENTAL
+void doca_netflow_cache_destroy(struct doca_netflow_cache *cache);
+
 /**
  * @brief Free the exporter memory and close the connection.
+ *
+ * Rings that were not destroyed are destroyed and the exporter thread is stopped.
  */
 __DOCA_EXPERIMENTAL
 void doca_netflow_exporter_destroy(void);
@@ -44,6 +44,7 @@ enum telemetry_status {
 	DOCA_TELEMETRY_INTERNAL_BUFFER_ERROR,
 	DOCA_TELEMETRY_BAD_STATE_ERROR,
 	DOCA_TELEMETRY_BAD_PARAM_ERROR,
+	DOCA_TELEMETRY_EVENTS_DROPPED_ERROR,
 };
 
 /**
@@ -143,6 +144,65 @@ struct doca_telemetry_buffer_attr_t {
 };
 
 
+/**
+ * @brief DOCA schema file write compression.
+ */
+enum doca_telemetry_file_compression {
+	DOCA_TELEMETRY_FILE_COMPRESSION_NONE,
+	/**< Buffers are written as is. */
+	DOCA_TELEMETRY_FILE_COMPRESSION_LZ4,
+	/**< Each flushed buffer is written as one LZ4 block. */
+	DOCA_TELEMETRY_FILE_COMPRESSION_ZSTD,
+	/**< Each flushed buffer is written as one zstd block. */
+};
+
+
+/**
+ * @brief Magic of the DOCA telemetry binary file index header, "DTIX".
+ */
+#define DOCA_TELEMETRY_FILE_INDEX_MAGIC         0x58495444
+/**
+ * @brief Version of the DOCA telemetry binary file index format.
+ */
+#define DOCA_TELEMETRY_FILE_INDEX_VERSION       1
+
+
+/**
+ * @brief DOCA telemetry binary file index header.
+ *
+ * Written at the beginning of each .idx file, before the index entries, so an
+ * offline reader can decode the data file without the writer configuration.
+ */
+struct doca_telemetry_file_index_header {
+	uint32_t                   magic;
+	/**< DOCA_TELEMETRY_FILE_INDEX_MAGIC. */
+	uint16_t                   version;
+	/**< DOCA_TELEMETRY_FILE_INDEX_VERSION of the writer. */
+	uint16_t                   compression;
+	/**< enum doca_telemetry_file_compression of the data file blocks. */
+} __attribute__((packed));
+
+
+/**
+ * @brief DOCA telemetry binary file index entry.
+ *
+ * When file index is enabled, each {source_tag}_{timestamp}.bin file has a
+ * {source_tag}_{timestamp}.idx file next to it, holding a
+ * doca_telemetry_file_index_header followed by one entry per flushed buffer,
+ * so a reader can seek to a time range without scanning the data file.
+ */
+struct doca_telemetry_file_index_entry {
+	doca_telemetry_timestamp_t timestamp;
+	/**< Timestamp of the first event in the buffer. */
+	uint64_t                   offset;
+	/**< Offset of the buffer in the data file. */
+	uint32_t                   size;
+	/**< Size of the buffer in the data file, compressed if enabled. */
+	uint32_t                   raw_size;
+	/**< Size of the buffer before compression. */
+} __attribute__((packed));
+
+
 /**
  * @brief DOCA schema file write attribute. Applied to all DOCA sources.
  *
@@ -162,6 +222,19 @@ struct doca_telemetry_file_write_attr_t {
 	/**< Maximum file age. Once current file is older than this threshold
 	 *   a new file will be created.
 	 */
+	bool                        mmap_enabled;
+	/**< Write the data file through memory mapped segments instead of
+	 *   buffered I/O. Disabled by the default.
+	 */
+	enum doca_telemetry_file_compression compression;
+	/**< Compression of each flushed buffer. None by the default. The
+	 *   compressed blocks are only located through the index file, so
+	 *   index_enabled must be set when compression is not none.
+	 */
+	bool                        index_enabled;
+	/**< Write a doca_telemetry_file_index_entry per flushed buffer to an
+	 *   index file. Disabled by the default.
+	 */
 };
 
 
@@ -210,6 +283,67 @@ struct doca_telemetry_ipc_timeout_attr_t {
 };
 
 
+/**
+ * @brief DOCA schema async flush full buffers policy.
+ */
+enum doca_telemetry_async_policy {
+	DOCA_TELEMETRY_ASYNC_POLICY_DROP,
+	/**< Drop the new events when no buffer is free. */
+	DOCA_TELEMETRY_ASYNC_POLICY_BLOCK,
+	/**< Wait for the flush thread to free a buffer. */
+};
+
+
+/**
+ * @brief DOCA schema async flush attribute. Applied to all DOCA sources.
+ *
+ * Use to enable/disable asynchronous flush. Disabled by default.
+ * When enabled, each source has spare buffers of buffer_size. Once a buffer is full,
+ * or upon invocation of doca_telemetry_source_flush(), the source swaps to a spare
+ * buffer and the full buffer is written to IPC, file and netflow by a flush thread
+ * owned by the library. The reporting thread never does the write itself.
+ */
+struct doca_telemetry_async_attr_t {
+	bool                              async_enabled;
+	/**< User defined switch for enabling/disabling asynchronous flush. */
+	uint8_t                           nb_spare_buffers;
+	/**< Number of spare buffers per source. 0 for default, which is 1. */
+	enum doca_telemetry_async_policy  policy;
+	/**< What to do when all the buffers of a source are full. Default is drop. */
+};
+
+
+/**
+ * @brief DOCA schema aggregated metric kinds.
+ */
+enum doca_telemetry_metric_kind {
+	DOCA_TELEMETRY_METRIC_COUNTER,
+	/**< Monotonic counter. Record: timestamp, uint64_t running total since the
+	 *   source was created, not the change since the previous interval.
+	 */
+	DOCA_TELEMETRY_METRIC_GAUGE,
+	/**< Last set value. Record: timestamp, int64_t value. */
+	DOCA_TELEMETRY_METRIC_HISTOGRAM,
+	/**< Fixed buckets histogram. Record: timestamp, uint64_t count per bucket
+	 *   (nb_bounds + 1 buckets, the last bucket counts values above the last
+	 *   bound), uint64_t sum of the values.
+	 */
+};
+
+
+/**
+ * @brief DOCA schema metrics attribute. Applied to all DOCA sources.
+ *
+ * Aggregated metrics are updated in the source and emitted as one record per
+ * metric per interval, see doca_telemetry_metric_add() for when the records are
+ * reported. The interval is set to 1000 msec by default.
+ */
+struct doca_telemetry_metrics_attr_t {
+	uint32_t interval_msec;
+	/**< Emit interval of the aggregated metrics. */
+};
+
+
 /* ================================ DOCA SCHEMA ================================ */
 /**
  * @brief Initialize DOCA schema to prepare it for setting attributes and adding types.
@@ -249,6 +383,39 @@ int doca_telemetry_schema_add_type(void *doca_schema,
 				   doca_telemetry_type_index_t *type_index);
 
 
+/**
+ * @brief Add an aggregated metric type to DOCA schema.
+ *
+ * The record type of the metric kind is created in the schema, see
+ * doca_telemetry_metric_kind. The metric is updated on a source with
+ * doca_telemetry_metric_add(), doca_telemetry_metric_set() or
+ * doca_telemetry_metric_observe(), and its record is reported by the source
+ * once per interval, instead of one record per event.
+ *
+ * @param doca_schema
+ * Schema to create type in.
+ * @param metric_name
+ * Name for the metric type.
+ * @param kind
+ * Metric kind.
+ * @param bounds
+ * Ascending upper bounds of the histogram buckets, NULL for other kinds.
+ * @param nb_bounds
+ * Number of bounds, 0 for other kinds.
+ * @param type_index
+ * Type index for the created type is written to this variable.
+ * @return
+ * 0 on success, a negative telemetry_status on error
+ */
+__DOCA_EXPERIMENTAL
+int doca_telemetry_schema_add_metric(void *doca_schema,
+				     const char *metric_name,
+				     enum doca_telemetry_metric_kind kind,
+				     const uint64_t *bounds,
+				     int nb_bounds,
+				     doca_telemetry_type_index_t *type_index);
+
+
 /**
  * @brief Destructor for DOCA schema.
  *
@@ -264,6 +431,9 @@ void doca_telemetry_schema_destroy(void *doca_schema);
  *
  * Do NOT add new types after this function was called.
  *
+ * Fails with DOCA_TELEMETRY_BAD_PARAM_ERROR if the file write attributes set
+ * a compression without index_enabled.
+ *
  * @param doca_schema
  * Input schema to start.
  * @return
@@ -328,6 +498,19 @@ void doca_telemetry_schema_ipc_attr_set(void *doca_schema,
 					struct doca_telemetry_ipc_attr_t *ipc_attr);
 
 
+/**
+ * @brief Set metrics attributes to DOCA schema.
+ *
+ * @param doca_schema
+ * Input schema.
+ * @param metrics_attr
+ * Attribute to set.
+ */
+__DOCA_EXPERIMENTAL
+void doca_telemetry_schema_metrics_attr_set(void *doca_schema,
+					    struct doca_telemetry_metrics_attr_t *metrics_attr);
+
+
 /**
  * @brief Set Opaque events attributes to DOCA shcema.
  *
@@ -340,6 +523,18 @@ __DOCA_EXPERIMENTAL
 void doca_telemetry_schema_opaque_events_attr_set(void *doca_schema,
 		struct doca_telemetry_opaque_events_attr_t *opaque_events_attr);
 
+/**
+ * @brief Set async flush attributes to DOCA schema.
+ *
+ * @param doca_schema
+ * Input schema.
+ * @param async_attr
+ * Attribute to set.
+ */
+__DOCA_EXPERIMENTAL
+void doca_telemetry_schema_async_attr_set(void *doca_schema,
+					  struct doca_telemetry_async_attr_t *async_attr);
+
 /* ================================ DOCA SOURCE ================================ */
 
 /**
@@ -348,6 +543,10 @@ void doca_telemetry_schema_opaque_events_attr_set(void *doca_schema,
  * To create a DOCA source, first call doca_telemetry_schema_start() to prepare
  * the DOCA schema.
  *
+ * A source is not thread safe and must be used by a single thread. Several
+ * sources can be created from the same schema, for example one source per
+ * lcore, each with its own buffer and source_id, and used without lock.
+ *
  * @param doca_schema
  * Schema from which source will be created.
  * @return
@@ -392,6 +591,97 @@ __DOCA_EXPERIMENTAL
 int doca_telemetry_source_report(void *doca_source, doca_telemetry_type_index_t index,
 				 void *data, int count);
 
+/**
+ * @brief Reserve room for events of the same type in the DOCA source buffer.
+ *
+ * Zero copy variant of doca_telemetry_source_report(). The events are written
+ * in place into the internal buffer, then reported by calling
+ * doca_telemetry_source_commit(). If the buffer does not have room for count
+ * events it is flushed first. Only one reservation can be pending on a source.
+ *
+ * In async flush mode with DOCA_TELEMETRY_ASYNC_POLICY_DROP, when all the
+ * buffers of the source are full, no room is reserved: NULL is returned and
+ * the count events are added to doca_telemetry_source_dropped_get(). A caller
+ * can tell this case from an error by checking if the dropped count grew.
+ *
+ * @param doca_source
+ * Source to report.
+ * @param index
+ * Type index in the DOCA schema.
+ * @param count
+ * Number of events to reserve, must fit in the buffer size.
+ * @return
+ * Pointer to the room for count events of the type, NULL on error.
+ */
+__DOCA_EXPERIMENTAL
+void *doca_telemetry_source_reserve(void *doca_source, doca_telemetry_type_index_t index,
+				    int count);
+
+/**
+ * @brief Commit the events written to the reserved room of the DOCA source.
+ *
+ * @param doca_source
+ * Source to report.
+ * @param count
+ * Number of events written, up to the reserved count.
+ * @return
+ * 0 on success, a negative telemetry_status on error
+ */
+__DOCA_EXPERIMENTAL
+int doca_telemetry_source_commit(void *doca_source, int count);
+
+/**
+ * @brief Add to a counter metric of the DOCA source.
+ *
+ * Metrics are kept per source, so the update is a plain increment, without
+ * lock or atomic operation. Once the interval passed, the next update of any
+ * metric of the source reports the records of all its metrics into the source
+ * buffer, same as doca_telemetry_source_report(). In sync flush mode this may
+ * flush the buffer and write it from the calling thread, use async flush mode
+ * to keep this off the datapath. A source whose metrics are not updated does
+ * not report them, the source thread should call doca_telemetry_source_flush()
+ * at least once per interval, which reports the pending records of all the
+ * metrics, to get one record per metric per interval.
+ *
+ * @param doca_source
+ * Source to update.
+ * @param index
+ * Type index of a DOCA_TELEMETRY_METRIC_COUNTER metric.
+ * @param value
+ * Value to add.
+ */
+__DOCA_EXPERIMENTAL
+void doca_telemetry_metric_add(void *doca_source, doca_telemetry_type_index_t index,
+			       uint64_t value);
+
+/**
+ * @brief Set a gauge metric of the DOCA source.
+ *
+ * @param doca_source
+ * Source to update.
+ * @param index
+ * Type index of a DOCA_TELEMETRY_METRIC_GAUGE metric.
+ * @param value
+ * Value to set.
+ */
+__DOCA_EXPERIMENTAL
+void doca_telemetry_metric_set(void *doca_source, doca_telemetry_type_index_t index,
+			       int64_t value);
+
+/**
+ * @brief Add a value to a histogram metric of the DOCA source.
+ *
+ * @param doca_source
+ * Source to update.
+ * @param index
+ * Type index of a DOCA_TELEMETRY_METRIC_HISTOGRAM metric.
+ * @param value
+ * Value to count in its bucket.
+ */
+__DOCA_EXPERIMENTAL
+void doca_telemetry_metric_observe(void *doca_source, doca_telemetry_type_index_t index,
+				   uint64_t value);
+
 /**
  * @brief Report opaque event data via DOCA source.
  *
@@ -470,12 +760,33 @@ doca_telemetry_timestamp_t doca_telemetry_timestamp_get(void);
 /**
  * @brief Immediately flush the data of the DOCA source.
  *
+ * The records of the aggregated metrics whose interval passed are reported
+ * first, so they are flushed too.
+ *
+ * In async flush mode, the buffer is handed to the flush thread and this function
+ * returns without waiting for the write.
+ *
  * @param doca_source
  * DOCA source to flush.
  */
 __DOCA_EXPERIMENTAL
 void doca_telemetry_source_flush(void *doca_source);
 
+/**
+ * @brief Get the number of events dropped by the DOCA source.
+ *
+ * Events are dropped in async flush mode with DOCA_TELEMETRY_ASYNC_POLICY_DROP,
+ * when all the buffers of the source are full. The report call then returns
+ * DOCA_TELEMETRY_EVENTS_DROPPED_ERROR, and the reserve call returns NULL.
+ *
+ * @param doca_source
+ * Input doca source.
+ * @return
+ * Number of events dropped since the source was started.
+ */
+__DOCA_EXPERIMENTAL
+uint64_t doca_telemetry_source_dropped_get(void *doca_source);
+
 /**
  * @brief Return status of IPC transport
  *
@@ -25,12 +25,13 @@
  * After creating conf file and invoke init function, the lib send function
  * can be called with netflow struct to send a netflow packet with the format
  * to the collector of choice specified in the conf file.
- * The lib uses the netflow protocol specified by cisco.
+ * The lib uses the netflow protocol specified by cisco, or IPFIX.
  * @see https://netflow.caligare.com/netflow_v9.htm
+ * @see https://datatracker.ietf.org/doc/html/rfc7011
  *
  * Limitations:
  *
- * The lib supports the netflow V9 format. The lib is not thread safe.
+ * The lib supports the netflow V9 and IPFIX (V10) formats. The lib is not thread safe.
  *
  * @{
  */
@@ -61,12 +62,22 @@ extern "C" {
 		0xbe, 0x6c, 0x71, 0x5a, 0x0f, 0x03, 0xad, 0xd6 \
 	}
 
+/**
+ * @brief Field flag, the field is variable length (IPFIX only).
+ *
+ * The field still takes 'length' bytes in the record, it holds a string padded
+ * with zeros and is sent with the length of the string.
+ */
+#define DOCA_TELEMETRY_NETFLOW_FIELD_FLAG_VARIABLE_LENGTH (1 << 0)
+
 /**
  * @brief One field in netflow template, please look at doca_telemetry_netflow_types for type macros
  */
 struct doca_telemetry_netflow_flowset_field {
-	uint16_t type;   /**< field number id (see link) */
-	uint16_t length; /**< field len in bytes (see link) */
+	uint16_t type;		    /**< field number id (see link) */
+	uint16_t length;	    /**< field len in bytes (see link) */
+	int flags;		    /**< DOCA_TELEMETRY_NETFLOW_FIELD_FLAG_* flags */
+	uint32_t enterprise_number; /**< IPFIX enterprise number, 0 for IANA fields */
 };
 
 /**
@@ -102,6 +113,12 @@ struct doca_telemetry_netflow_send_attr_t {
 	/**< User defined netflow collector's IP address */
 	uint16_t netflow_collector_port;
 	/**< User defined netflow collector's port */
+	uint16_t version;
+	/**< Export format, 0 or 9 for netflow V9 (default), 10 for IPFIX */
+	uint16_t mtu;
+	/**< IPFIX only - max packet size in bytes, 0 for default (1500) */
+	uint32_t template_timeout;
+	/**< IPFIX only - templates resend period in seconds, 0 for default (600) */
 };
 
 /**
@@ -200,7 +217,7 @@ int doca_telemetry_netflow_start(struct doca_telemetry_source_name_attr_t *sourc
  *   0 on success, a negative telemetry_status on error.
  * @note When sending more then 30 records the lib splits the records
  * to multiple packets because each packet can only send up to 30 records
- * (Netflow protocol limit)
+ * (Netflow protocol limit). In IPFIX mode the records are split by mtu.
  */
 __DOCA_EXPERIMENTAL
 int doca_telemetry_netflow_send(const struct doca_telemetry_netflow_template *netflow_template,
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2021 NVIDIA CORPORATION & AFFILIATES, ALL RIGHTS RESERVED.
+ *
+ * This software product is a proprietary product of NVIDIA CORPORATION &
+ * AFFILIATES (the "Company") and all right, title, and interest in and to the
+ * software product, including all associated intellectual property rights, are
+ * and shall remain exclusively with the Company.
+ *
+ * This software product is governed by the End User License Agreement
+ * provided with the software product.
+ *
+ */
+
+/**
+ * @file doca_trace.h
+ * @page trace
+ * @defgroup TRACE Tracepoints
+ *
+ * Static tracepoints (USDT) of the DOCA libraries hot paths.
+ *
+ * The DOCA libraries are built with USDT probes of the DOCA_TRACE_PROVIDER
+ * provider on their hot paths. Each probe has a semaphore, set by the tracer
+ * when it attaches, and is guarded by an is-enabled check of it, so when no
+ * tracer is attached a probe costs one predicted branch and its arguments, such
+ * as the cycles count, are not computed. The probes can be used in production
+ * without rebuilding. Tracers must support USDT semaphores to see the probes
+ * fire. They can be listed and attached with standard tools, for example:
+ *
+ * perf list 'sdt_doca:*'
+ *
+ * bpftrace -e 'usdt:/path/to/libdoca_flow.so:doca:flow_add_entry_done
+ *              { @cycles = hist(arg2); }'
+ *
+ * Each traced function has a _start probe on entry, and a _done probe on return.
+ * Unless noted otherwise, the probes arguments are:
+ *
+ * start: arg0 - queue or context, arg1 - rte_rdtsc() cycles timestamp.
+ *
+ * done: arg0 - queue or context, arg1 - number of handled items or negative
+ * error, arg2 - cycles spent in the function.
+ *
+ * @{
+ */
+
+#ifndef _DOCA_TRACE_H_
+#define _DOCA_TRACE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief USDT provider name of the DOCA libraries probes
+ */
+#define DOCA_TRACE_PROVIDER "doca"
+
+/**
+ * doca_flow_pipe_add_entry, doca_flow_pipe_add_entry_by_key and
+ * doca_flow_control_pipe_add_entry. arg0 is pipe_queue, done arg1 is 1 or
+ * negative error.
+ */
+#define DOCA_TRACE_FLOW_ADD_ENTRY_START "flow_add_entry_start"
+#define DOCA_TRACE_FLOW_ADD_ENTRY_DONE "flow_add_entry_done"
+/**
+ * doca_flow_pipe_add_entries_burst. arg0 is pipe_queue, done arg1 is the number
+ * of posted entries.
+ */
+#define DOCA_TRACE_FLOW_ADD_ENTRIES_BURST_START "flow_add_entries_burst_start"
+#define DOCA_TRACE_FLOW_ADD_ENTRIES_BURST_DONE "flow_add_entries_burst_done"
+/**
+ * doca_flow_entries_process. arg0 is pipe_queue, done arg1 is the number of
+ * completed entries.
+ */
+#define DOCA_TRACE_FLOW_ENTRIES_PROCESS_START "flow_entries_process_start"
+#define DOCA_TRACE_FLOW_ENTRIES_PROCESS_DONE "flow_entries_process_done"
+/**
+ * doca_flow_handle_aging and doca_flow_handle_aging_events. arg0 is queue, done
+ * arg1 is the number of aged flows, -1 on full cycle.
+ */
+#define DOCA_TRACE_FLOW_HANDLE_AGING_START "flow_handle_aging_start"
+#define DOCA_TRACE_FLOW_HANDLE_AGING_DONE "flow_handle_aging_done"
+/**
+ * doca_dpi_enqueue, doca_dpi_enqueue_payload and doca_dpi_enqueue_burst. arg0 is
+ * dpi_q, done arg1 is the number of enqueued packets or negative error.
+ */
+#define DOCA_TRACE_DPI_ENQUEUE_START "dpi_enqueue_start"
+#define DOCA_TRACE_DPI_ENQUEUE_DONE "dpi_enqueue_done"
+/**
+ * doca_dpi_dequeue and doca_dpi_dequeue_burst. arg0 is dpi_q, done arg1 is the
+ * number of dequeued results.
+ */
+#define DOCA_TRACE_DPI_DEQUEUE_START "dpi_dequeue_start"
+#define DOCA_TRACE_DPI_DEQUEUE_DONE "dpi_dequeue_done"
+/**
+ * DPI job latency, fired on dequeue for each result. arg0 is dpi_q, arg1 is the
+ * cycles from enqueue to dequeue.
+ */
+#define DOCA_TRACE_DPI_JOB_LATENCY "dpi_job_latency"
+/**
+ * doca_telemetry_source_report and doca_telemetry_source_commit. arg0 is the
+ * source, done arg1 is the number of events.
+ */
+#define DOCA_TRACE_TELEMETRY_REPORT_START "telemetry_report_start"
+#define DOCA_TRACE_TELEMETRY_REPORT_DONE "telemetry_report_done"
+/**
+ * Telemetry source buffer flush, by the reporting thread or the flush thread.
+ * arg0 is the source, done arg1 is the number of flushed bytes.
+ */
+#define DOCA_TRACE_TELEMETRY_FLUSH_START "telemetry_flush_start"
+#define DOCA_TRACE_TELEMETRY_FLUSH_DONE "telemetry_flush_done"
+/**
+ * doca_netflow_exporter_send, doca_telemetry_netflow_send and the exporter thread
+ * sends. arg0 is 0, done arg1 is the number of sent records.
+ */
+#define DOCA_TRACE_NETFLOW_SEND_START "netflow_send_start"
+#define DOCA_TRACE_NETFLOW_SEND_DONE "netflow_send_done"
+/**
+ * doca_apsh_processes_get and doca_apsh_processes_delta_get. arg0 is the system,
+ * done arg1 is the number of returned processes.
+ */
+#define DOCA_TRACE_APSH_PROCESSES_GET_START "apsh_processes_get_start"
+#define DOCA_TRACE_APSH_PROCESSES_GET_DONE "apsh_processes_get_done"
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+
+#endif /* _DOCA_TRACE_H_ */